@@ -36,6 +36,11 @@ public:
 	 */
 	static void GameLoop();
 
+	/**
+	 * Called every game-tick to let AIs do something, running the scripts in parallel.
+	 */
+	static void ParallelGameLoop();
+
 	/**
 	 * Get the current AI tick.
 	 */
@@ -13,10 +13,13 @@
 #include "../company_base.h"
 #include "../company_func.h"
 #include "../network/network.h"
+#include "../network/network_func.h"
 #include "../window_func.h"
 #include "../framerate_type.h"
 #include "../scope_info.h"
 #include "../string_func.h"
+#include "../worker_thread.h"
+#include "../script/squirrel.hpp"
 #include "ai_scanner.hpp"
 #include "ai_instance.hpp"
 #include "ai_config.hpp"
@@ -79,6 +82,11 @@
 	if ((AI::frame_counter & ((1 << (4 - _settings_game.difficulty.competitor_speed)) - 1)) != 0) return;
 
 	Backup<CompanyID> cur_company(_current_company, FILE_LINE);
+	if (_networking && _settings_client.network.parallel_ai_scripts && _general_worker_pool.GetWorkerCount() > 0) {
+		AI::ParallelGameLoop();
+		cur_company.Restore();
+		return;
+	}
 	for (const Company *c : Company::Iterate()) {
 		if (c->is_ai) {
 			SCOPE_INFO_FMT([&], "AI::GameLoop: %i: %s (v%d)\n", (int)c->index, c->ai_info->GetName().c_str(), c->ai_info->GetVersion());
@@ -97,6 +105,51 @@
 	cur_company.Restore();
 }
 
+/**
+ * Run the scripts of all AI companies in parallel on the worker threads.
+ * The Squirrel code of the scripts runs concurrently, their access to the game state is serialised, see ScriptParallelScope.
+ * This is only used on network servers, where commands of scripts are queued instead of executed immediately.
+ * The queued commands are deferred and then queued in company order, as if the scripts ran one after another.
+ */
+/* static */ void AI::ParallelGameLoop()
+{
+	std::vector<Company *> ai_companies;
+	for (Company *c : Company::Iterate()) {
+		if (c->is_ai) {
+			ai_companies.push_back(c);
+		} else {
+			PerformanceMeasurer::SetInactive((PerformanceElement)(PFE_AI0 + c->index));
+		}
+	}
+
+	NetworkServerDeferLocalCommands();
+	_general_worker_pool.ParallelFor(0, ai_companies.size(), 1, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			Company *c = ai_companies[i];
+			SCOPE_INFO_FMT([&], "AI::ParallelGameLoop: %i: %s (v%d)\n", (int)c->index, c->ai_info->GetName().c_str(), c->ai_info->GetVersion());
+			PerformanceMeasurer framerate((PerformanceElement)(PFE_AI0 + c->index));
+			{
+				ScriptParallelScope parallel(c->index);
+				c->ai_instance->GameLoop();
+				/* Only count the time spent running this script, not the time spent waiting for the others */
+				framerate.ExcludeTime(parallel.GetLockWaitTime());
+			}
+		}
+	});
+	NetworkServerQueueDeferredLocalCommands();
+
+	/* Occasionally collect garbage; every 255 ticks do one company.
+	 * Effectively collecting garbage once every two months per AI. */
+	if ((AI::frame_counter & 255) == 0) {
+		Company *c = Company::GetIfValid((CompanyID)GB(AI::frame_counter, 8, 4));
+		if (c != nullptr && c->is_ai) {
+			Backup<CompanyID> cur_company(_current_company, c->index, FILE_LINE);
+			c->ai_instance->CollectGarbage();
+			cur_company.Restore();
+		}
+	}
+}
+
 /* static */ uint AI::GetTick()
 {
 	return AI::frame_counter;
@@ -911,6 +911,35 @@ void StationCargoList::Append(CargoPacket *cp, StationID next)
 	list.push_back(cp);
 }
 
+/**
+ * Merge adjacent packets with the same next hop which are mergeable but have not been merged on append,
+ * e.g. packets which were inserted by rerouting or which have since been reduced in size.
+ * Only adjacent packets are merged, so the order in which cargo is loaded is unchanged.
+ * The amount, feeder share and deferred payments of the cargo are unchanged, so the cache does not need updating.
+ * @return Number of packets which were merged into other packets.
+ */
+uint StationCargoList::Compact()
+{
+	uint merged = 0;
+	for (auto &it : this->packets) {
+		StationCargoPacketMap::List &list = it.second;
+		if (list.size() < 2) continue;
+
+		size_t out = 1;
+		for (size_t i = 1; i < list.size(); i++) {
+			CargoPacket *cp = list[i];
+			CargoPacket *prev = list[out - 1];
+			if (prev->loaded_at_xy == cp->loaded_at_xy && StationCargoList::TryMerge(prev, cp)) {
+				merged++;
+				continue;
+			}
+			list[out++] = cp;
+		}
+		list.resize(out);
+	}
+	return merged;
+}
+
 /**
  * Shifts cargo from the front of the packet list for a specific station and
  * applies some action to it.
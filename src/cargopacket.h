@@ -534,6 +534,7 @@ public:
 	uint ShiftCargoFromSource(Taction action, StationID source, StationIDStack next, bool include_invalid);
 
 	void Append(CargoPacket *cp, StationID next);
+	uint Compact();
 
 	/**
 	 * Check for cargo headed for a specific station.
@@ -9,6 +9,7 @@
 
 #include "stdafx.h"
 #include "clear_map.h"
+#include "clear_func.h"
 #include "command_func.h"
 #include "landscape.h"
 #include "genworld.h"
@@ -243,8 +244,13 @@ static void UpdateFences(TileIndex tile)
 }
 
 
-/** Convert to or from snowy tiles. */
-static void TileLoopClearAlps(TileIndex tile)
+/**
+ * Convert to or from snowy tiles.
+ * @param tile The tile.
+ * @param mark_dirty Function called as mark_dirty(tile, flags) when the tile has to be redrawn.
+ */
+template <typename F>
+static void TileLoopClearAlps(TileIndex tile, F mark_dirty)
 {
 	int k;
 	int h = (int)TileHeight(tile);
@@ -265,7 +271,7 @@ static void TileLoopClearAlps(TileIndex tile)
 		/* At or above the snow line, make snow tile if needed. */
 		if (!IsSnowTile(tile)) {
 			MakeSnow(tile);
-			MarkTileDirtyByTile(tile);
+			mark_dirty(tile, VMDF_NONE);
 			return;
 		}
 	}
@@ -282,7 +288,7 @@ static void TileLoopClearAlps(TileIndex tile)
 		if (k >= 0) return;
 		ClearSnow(tile);
 	}
-	MarkTileDirtyByTile(tile);
+	mark_dirty(tile, VMDF_NONE);
 }
 
 /**
@@ -301,7 +307,13 @@ static inline bool NeighbourIsNormal(TileIndex tile)
 	return false;
 }
 
-static void TileLoopClearDesert(TileIndex tile)
+/**
+ * Convert to or from desert tiles.
+ * @param tile The tile.
+ * @param mark_dirty Function called as mark_dirty(tile, flags) when the tile has to be redrawn.
+ */
+template <typename F>
+static void TileLoopClearDesert(TileIndex tile, F mark_dirty)
 {
 	/* Current desert level - 0 if it is not desert */
 	uint current = 0;
@@ -324,16 +336,20 @@ static void TileLoopClearDesert(TileIndex tile)
 		SetClearGroundDensity(tile, CLEAR_DESERT, expected);
 	}
 
-	MarkTileDirtyByTile(tile);
+	mark_dirty(tile, VMDF_NONE);
 }
 
-static void TileLoop_Clear(TileIndex tile)
+/**
+ * Tile loop of clear tiles, except for the ambient sound effect.
+ * @param tile The tile.
+ * @param mark_dirty Function called as mark_dirty(tile, flags) when the tile has to be redrawn.
+ */
+template <typename F>
+static void TileLoopClearImpl(TileIndex tile, F mark_dirty)
 {
-	AmbientSoundEffect(tile);
-
 	switch (_settings_game.game_creation.landscape) {
-		case LT_TROPIC: TileLoopClearDesert(tile); break;
-		case LT_ARCTIC: TileLoopClearAlps(tile);   break;
+		case LT_TROPIC: TileLoopClearDesert(tile, mark_dirty); break;
+		case LT_ARCTIC: TileLoopClearAlps(tile, mark_dirty);   break;
 	}
 
 	switch (GetClearGround(tile)) {
@@ -379,7 +395,43 @@ static void TileLoop_Clear(TileIndex tile)
 			return;
 	}
 
-	MarkTileDirtyByTile(tile, VMDF_NOT_MAP_MODE_NON_VEG);
+	mark_dirty(tile, VMDF_NOT_MAP_MODE_NON_VEG);
+}
+
+static void TileLoop_Clear(TileIndex tile)
+{
+	AmbientSoundEffect(tile);
+
+	TileLoopClearImpl(tile, [](TileIndex tile, ViewportMarkDirtyFlags flags) {
+		MarkTileDirtyByTile(tile, flags);
+	});
+}
+
+/**
+ * Whether the tile loop of a tile can be run by TileLoopClearParallel.
+ * This is the case for clear tiles other than fields, outside the scenario editor and without the ambient sound effect callback.
+ * The tile loop of these tiles only changes the tile itself, and does not use the random generator.
+ * @param tile The tile.
+ * @return True if TileLoopClearParallel can be used for this tile.
+ */
+bool IsClearTileLoopParallelSafe(TileIndex tile)
+{
+	return IsTileType(tile, MP_CLEAR) && !IsClearGround(tile, CLEAR_FIELDS) && _game_mode != GM_EDITOR && !HasGrfMiscBit(GMB_AMBIENT_SOUND_CALLBACK);
+}
+
+/**
+ * Tile loop of a clear tile, which may be run concurrently for different tiles.
+ * The tile must satisfy IsClearTileLoopParallelSafe.
+ * @param tile The tile.
+ * @param[out] dirty Tiles which have to be redrawn, these must be marked dirty on the main thread.
+ */
+void TileLoopClearParallel(TileIndex tile, std::vector<std::pair<TileIndex, ViewportMarkDirtyFlags>> &dirty)
+{
+	dbg_assert(IsClearTileLoopParallelSafe(tile));
+
+	TileLoopClearImpl(tile, [&](TileIndex tile, ViewportMarkDirtyFlags flags) {
+		dirty.emplace_back(tile, flags);
+	});
 }
 
 void GenerateClearTile()
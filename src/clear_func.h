@@ -11,6 +11,10 @@
 #define CLEAR_FUNC_H
 
 #include "tile_cmd.h"
+#include "viewport_type.h"
+
+#include <utility>
+#include <vector>
 
 void DrawHillyLandTile(const TileInfo *ti);
 void DrawClearLandTile(const TileInfo *ti, byte set);
@@ -21,4 +25,7 @@ SpriteID GetSpriteIDForRocks(const Slope slope, const uint tile_hash);
 SpriteID GetSpriteIDForFields(const Slope slope, const uint field_type);
 SpriteID GetSpriteIDForSnowDesert(const Slope slope, const uint density);
 
+bool IsClearTileLoopParallelSafe(TileIndex tile);
+void TileLoopClearParallel(TileIndex tile, std::vector<std::pair<TileIndex, ViewportMarkDirtyFlags>> &dirty);
+
 #endif /* CLEAR_FUNC_H */
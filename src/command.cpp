@@ -861,7 +861,10 @@ CommandCost DoCommandEx(TileIndex tile, uint32 p1, uint32 p2, uint64 p3, DoComma
 	/* Execute the command here. All cost-relevant functions set the expenses type
 	 * themselves to the cost object at some point */
 	if (_docommand_recursive == 1) _cleared_object_areas.clear();
-	res = command.Execute(tile, flags, p1, p2, p3, text, aux_data);
+	{
+		SignalSegmentCacheSuspender signal_cache_suspend;
+		res = command.Execute(tile, flags, p1, p2, p3, text, aux_data);
+	}
 	if (res.Failed()) {
 error:
 		_docommand_recursive--;
@@ -1209,7 +1212,11 @@ CommandCost DoCommandPInternal(TileIndex tile, uint32 p1, uint32 p2, uint64 p3,
 	 * use the construction one */
 	_cleared_object_areas.clear();
 	BasePersistentStorageArray::SwitchMode(PSM_ENTER_COMMAND);
-	CommandCost res2 = command.Execute(tile, flags | DC_EXEC, p1, p2, p3, text, aux_data);
+	CommandCost res2;
+	{
+		SignalSegmentCacheSuspender signal_cache_suspend;
+		res2 = command.Execute(tile, flags | DC_EXEC, p1, p2, p3, text, aux_data);
+	}
 	BasePersistentStorageArray::SwitchMode(PSM_LEAVE_COMMAND);
 
 	if (cmd_id == CMD_COMPANY_CTRL) {
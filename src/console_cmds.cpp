@@ -869,6 +869,17 @@ DEF_CONSOLE_CMD(ConStatus)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConJoinStats)
+{
+	if (argc == 0) {
+		IConsoleHelp("Show statistics about clients downloading the map. Usage 'join_stats'");
+		return true;
+	}
+
+	NetworkServerShowJoinStatsToConsole();
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConServerInfo)
 {
 	if (argc == 0) {
@@ -2627,6 +2638,67 @@ DEF_CONSOLE_CMD(ConVehicleStats)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConVehicleTileHashStats)
+{
+	if (argc == 0) {
+		IConsoleHelp("Dump vehicle tile hash occupancy stats.");
+		IConsoleHelp("Usage: 'dump_veh_hash_stats [<probe rounds>]'");
+		IConsoleHelp("  If probe rounds is given, also time that many rounds of vehicle position probes at the tile of each vehicle.");
+		return true;
+	}
+
+	uint32 probe_rounds = 0;
+	if (argc > 1 && !GetArgumentInteger(&probe_rounds, argv[1])) return false;
+
+	extern void DumpVehicleTileHashStats(char *buffer, const char *last, uint probe_rounds);
+	char buffer[32768];
+	DumpVehicleTileHashStats(buffer, lastof(buffer), probe_rounds);
+	PrintLineByLine(buffer);
+	return true;
+}
+
+DEF_CONSOLE_CMD(ConStationCatchmentIndexStats)
+{
+	if (argc == 0) {
+		IConsoleHelp("Dump station catchment index stats.");
+		return true;
+	}
+
+	extern void DumpStationCatchmentIndexStats(char *buffer, const char *last);
+	char buffer[1024];
+	DumpStationCatchmentIndexStats(buffer, lastof(buffer));
+	PrintLineByLine(buffer);
+	return true;
+}
+
+DEF_CONSOLE_CMD(ConYapfCacheStats)
+{
+	if (argc == 0) {
+		IConsoleHelp("Dump YAPF rail segment cost cache stats.");
+		return true;
+	}
+
+	extern void DumpYapfRailSegmentCostCacheStats(char *buffer, const char *last);
+	char buffer[1024];
+	DumpYapfRailSegmentCostCacheStats(buffer, lastof(buffer));
+	PrintLineByLine(buffer);
+	return true;
+}
+
+DEF_CONSOLE_CMD(ConSignalSegmentCacheStats)
+{
+	if (argc == 0) {
+		IConsoleHelp("Dump signal segment cache stats.");
+		return true;
+	}
+
+	extern void DumpSignalSegmentCacheStats(char *buffer, const char *last);
+	char buffer[1024];
+	DumpSignalSegmentCacheStats(buffer, lastof(buffer));
+	PrintLineByLine(buffer);
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConMapStats)
 {
 	if (argc == 0) {
@@ -3760,6 +3832,7 @@ void IConsoleStdLibRegister()
 	IConsole::CmdRegister("clients",                 ConNetworkClients,   ConHookNeedNetwork);
 	IConsole::CmdRegister("status",                  ConStatus,           ConHookServerOnly);
 	IConsole::CmdRegister("server_info",             ConServerInfo,       ConHookServerOnly);
+	IConsole::CmdRegister("join_stats",              ConJoinStats,        ConHookServerOnly);
 	IConsole::AliasRegister("info",                  "server_info");
 	IConsole::CmdRegister("reconnect",               ConNetworkReconnect, ConHookClientOnly);
 	IConsole::CmdRegister("rcon",                    ConRcon,             ConHookNeedNetwork);
@@ -3834,8 +3907,12 @@ void IConsoleStdLibRegister()
 	IConsole::CmdRegister("dump_inflation",          ConDumpInflation,    nullptr, true);
 	IConsole::CmdRegister("dump_cpdp_stats",         ConDumpCpdpStats,    nullptr, true);
 	IConsole::CmdRegister("dump_veh_stats",          ConVehicleStats,     nullptr, true);
+	IConsole::CmdRegister("dump_veh_hash_stats",     ConVehicleTileHashStats, nullptr, true);
 	IConsole::CmdRegister("dump_map_stats",          ConMapStats,         nullptr, true);
 	IConsole::CmdRegister("dump_st_flow_stats",      ConStFlowStats,      nullptr, true);
+	IConsole::CmdRegister("dump_st_catchment_stats", ConStationCatchmentIndexStats, nullptr, true);
+	IConsole::CmdRegister("dump_yapf_cache_stats",   ConYapfCacheStats,   nullptr, true);
+	IConsole::CmdRegister("dump_signal_cache_stats", ConSignalSegmentCacheStats, nullptr, true);
 	IConsole::CmdRegister("dump_game_events",        ConDumpGameEvents,   nullptr, true);
 	IConsole::CmdRegister("dump_load_debug_log",     ConDumpLoadDebugLog, nullptr, true);
 	IConsole::CmdRegister("dump_load_debug_config",  ConDumpLoadDebugConfig, nullptr, true);
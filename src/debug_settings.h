@@ -20,6 +20,9 @@ enum ChickenBitFlags {
 	DCBF_DESYNC_CHECK_POST_COMMAND     = 3,
 	DCBF_DESYNC_CHECK_NO_GENERAL       = 4,
 	DCBF_DESYNC_CHECK_PERIODIC_SIGNALS = 5,
+	DCBF_NO_SIGNAL_SEGMENT_CACHE       = 6,
+	DCBF_NO_PARALLEL_DEPOT_SEARCH      = 7,
+	DCBF_NO_VEHICLE_CALLBACK_MEMO      = 8,
 };
 
 inline bool HasChickenBit(ChickenBitFlags flag)
@@ -37,6 +40,7 @@ enum NewGRFOptimiserFlags {
 	NGOF_NO_OPT_VARACT2_INSERT_JUMPS    = 6,
 	NGOF_NO_OPT_VARACT2_CB_QUICK_EXIT   = 7,
 	NGOF_NO_OPT_VARACT2_PROC_INLINE     = 8,
+	NGOF_NO_VARACT2_PROGRAM             = 9,
 };
 
 inline bool HasGrfOptimiserFlag(NewGRFOptimiserFlags flag)
@@ -307,6 +307,9 @@ int UpdateCompanyRatingAndValue(Company *c, bool update)
  */
 void ChangeOwnershipOfCompanyItems(Owner old_owner, Owner new_owner)
 {
+	/* Tile owners change, which affects signal segments. */
+	SignalSegmentCacheSuspender signal_cache_suspend;
+
 	/* We need to set _current_company to old_owner before we try to move
 	 * the client. This is needed as it needs to know whether "you" really
 	 * are the current local company. */
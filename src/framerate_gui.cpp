@@ -23,6 +23,8 @@
 #include "ai/ai_instance.hpp"
 #include "game/game.hpp"
 #include "game/game_instance.hpp"
+#include "fileio_func.h"
+#include "debug.h"
 
 #include "widgets/framerate_widget.h"
 
@@ -33,12 +35,24 @@
 #endif
 #include <vector>
 
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(UNIX)
+#include <sys/resource.h>
+#endif
+
 #include "safeguards.h"
 
 static std::mutex _sound_perf_lock;
 static std::atomic<bool> _sound_perf_pending;
 static std::vector<TimingMeasurement> _sound_perf_measurements;
 
+/** Whether every measurement is currently also being recorded for a benchmark report. */
+static bool _pf_benchmark_active = false;
+/** Time at which the benchmark was started. */
+static TimingMeasurement _pf_benchmark_start_time;
+
 /**
  * Private declarations for performance measurement implementation
  */
@@ -71,6 +85,11 @@ namespace {
 		/** Start time for current accumulation cycle */
 		TimingMeasurement acc_timestamp;
 
+		/** All durations recorded since the benchmark was started, see StartPerformanceBenchmark */
+		std::vector<TimingMeasurement> benchmark_durations;
+		/** Whether the current accumulation cycle started while the benchmark was active */
+		bool benchmark_acc_valid = false;
+
 		/**
 		 * Initialize a data element with an expected collection rate
 		 * @param expected_rate
@@ -82,6 +101,7 @@ namespace {
 		/** Collect a complete measurement, given start and ending times for a processing block */
 		void Add(TimingMeasurement start_time, TimingMeasurement end_time)
 		{
+			if (_pf_benchmark_active) this->benchmark_durations.push_back(end_time - start_time);
 			this->durations[this->next_index] = end_time - start_time;
 			this->timestamps[this->next_index] = start_time;
 			this->prev_index = this->next_index;
@@ -100,6 +120,9 @@ namespace {
 			if (this->next_index >= NUM_FRAMERATE_POINTS) this->next_index = 0;
 			this->num_valid = std::min(NUM_FRAMERATE_POINTS, this->num_valid + 1);
 
+			if (_pf_benchmark_active && this->benchmark_acc_valid) this->benchmark_durations.push_back(this->acc_duration);
+			this->benchmark_acc_valid = _pf_benchmark_active;
+
 			this->acc_duration = 0;
 			this->acc_timestamp = start_time;
 		}
@@ -277,6 +300,15 @@ void PerformanceMeasurer::SetExpectedRate(double rate)
 	_pf_data[this->elem].expected_rate = rate;
 }
 
+/**
+ * Exclude time from the current cycle, e.g. time spent waiting for other threads.
+ * @param us Time to exclude, in microseconds.
+ */
+void PerformanceMeasurer::ExcludeTime(TimingMeasurement us)
+{
+	this->start_time += us;
+}
+
 /** Mark a performance element as not currently in use. */
 /* static */ void PerformanceMeasurer::SetInactive(PerformanceElement elem)
 {
@@ -1107,3 +1139,122 @@ void ProcessPendingPerformanceMeasurements()
 		_sound_perf_pending.store(false, std::memory_order_relaxed);
 	}
 }
+
+/** Identifiers of the performance elements in benchmark reports, AI elements are numbered instead. */
+static const char * const BENCHMARK_ELEMENT_NAMES[PFE_AI0] = {
+	"gameloop",
+	"gl_economy",
+	"gl_trains",
+	"gl_roadvehs",
+	"gl_ships",
+	"gl_aircraft",
+	"gl_landscape",
+	"gl_linkgraph",
+	"drawing",
+	"drawworld",
+	"video",
+	"sound",
+	"allscripts",
+	"gamescript",
+};
+
+/**
+ * Get the peak resident memory usage of this process.
+ * @return Peak memory usage in bytes, or 0 if unknown.
+ */
+static uint64 GetPeakMemoryUsage()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS pmc;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return pmc.PeakWorkingSetSize;
+#elif defined(UNIX)
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+		return (uint64)usage.ru_maxrss;
+#else
+		return (uint64)usage.ru_maxrss * 1024;
+#endif
+	}
+#endif
+	return 0;
+}
+
+/**
+ * Start recording every measurement of every performance element, for WritePerformanceBenchmarkReport.
+ * Any previously recorded benchmark measurements are discarded.
+ */
+void StartPerformanceBenchmark()
+{
+	for (PerformanceData &pf : _pf_data) {
+		pf.benchmark_durations.clear();
+		pf.benchmark_acc_valid = false;
+	}
+	_pf_benchmark_active = true;
+	_pf_benchmark_start_time = GetPerformanceTimer();
+}
+
+/**
+ * Stop recording benchmark measurements, and write a JSON report of them.
+ * For each performance element which recorded anything, the report contains the number of samples and
+ * the minimum, mean, 99th percentile and maximum durations in milliseconds.
+ * @param filename File to write the report to, or an empty string to write it to stdout.
+ * @param ticks Number of game ticks which were run since the benchmark was started.
+ */
+void WritePerformanceBenchmarkReport(const std::string &filename, uint ticks)
+{
+	_pf_benchmark_active = false;
+	const TimingMeasurement wall_time = GetPerformanceTimer() - _pf_benchmark_start_time;
+
+	FILE *f = stdout;
+	if (!filename.empty()) {
+		f = FioFOpenFile(filename, "wt", Subdirectory::NO_DIRECTORY);
+		if (f == nullptr) {
+			DEBUG(misc, 0, "Failed to open benchmark report file: %s", filename.c_str());
+			return;
+		}
+	}
+
+	const double ms = 1000.0 / TIMESTAMP_PRECISION;
+
+	fputs("{\n", f);
+	fprintf(f, "\t\"ticks\": %u,\n", ticks);
+	fprintf(f, "\t\"wall_time_ms\": %.3f,\n", wall_time * ms);
+	fprintf(f, "\t\"ticks_per_second\": %.3f,\n", wall_time > 0 ? (double)ticks * TIMESTAMP_PRECISION / wall_time : 0.0);
+	fprintf(f, "\t\"peak_memory_bytes\": " OTTD_PRINTF64U ",\n", GetPeakMemoryUsage());
+	fputs("\t\"elements\": {", f);
+
+	bool first = true;
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		std::vector<TimingMeasurement> &durations = _pf_data[e].benchmark_durations;
+		if (durations.empty()) continue;
+
+		std::sort(durations.begin(), durations.end());
+		double total = 0;
+		for (TimingMeasurement d : durations) total += d;
+		size_t p99_index = std::min(durations.size() - 1, (durations.size() * 99) / 100);
+
+		char name[16];
+		if (e < PFE_AI0) {
+			strecpy(name, BENCHMARK_ELEMENT_NAMES[e], lastof(name));
+		} else {
+			seprintf(name, lastof(name), "ai%d", e - PFE_AI0 + 1);
+		}
+
+		fprintf(f, "%s\n\t\t\"%s\": { \"samples\": " PRINTF_SIZE ", \"min_ms\": %.3f, \"mean_ms\": %.3f, \"p99_ms\": %.3f, \"max_ms\": %.3f }",
+				first ? "" : ",", name, durations.size(), durations.front() * ms, total * ms / durations.size(),
+				durations[p99_index] * ms, durations.back() * ms);
+		first = false;
+
+		durations.clear();
+		durations.shrink_to_fit();
+	}
+
+	fputs(first ? "}\n}\n" : "\n\t}\n}\n", f);
+
+	if (f != stdout) {
+		FioFCloseFile(f);
+	} else {
+		fflush(f);
+	}
+}
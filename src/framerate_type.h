@@ -37,6 +37,7 @@
 
 #include "stdafx.h"
 #include "core/enum_type.hpp"
+#include <string>
 
 /**
  * Elements of game performance that can be measured.
@@ -96,6 +97,7 @@ public:
 	PerformanceMeasurer(PerformanceElement elem);
 	~PerformanceMeasurer();
 	void SetExpectedRate(double rate);
+	void ExcludeTime(TimingMeasurement us);
 	static void SetInactive(PerformanceElement elem);
 	static void Paused(PerformanceElement elem);
 };
@@ -123,4 +125,7 @@ public:
 void ShowFramerateWindow();
 void ProcessPendingPerformanceMeasurements();
 
+void StartPerformanceBenchmark();
+void WritePerformanceBenchmarkReport(const std::string &filename, uint ticks);
+
 #endif /* FRAMERATE_TYPE_H */
@@ -1282,7 +1282,16 @@ void OnTick_Industry()
 	if (_game_mode == GM_EDITOR) return;
 
 	_scaled_production_ticks = ScaleQuantity(INDUSTRY_PRODUCE_TICKS, -_settings_game.economy.industry_cargo_scale_factor);
+	const bool scaled_production = (_settings_game.economy.industry_cargo_scale_factor != 0);
 	for (Industry *i : Industry::Iterate()) {
+		/* In most ticks an industry neither plays a sound nor produces, so only decrement the counter without
+		 * looking up the industry spec. The counter tests are the same as in ProduceIndustryGoods. */
+		const uint16 next_counter = i->counter - 1;
+		if ((i->counter & 0x3F) != 0 && (next_counter % INDUSTRY_PRODUCE_TICKS) != 0 &&
+				(!scaled_production || (next_counter % _scaled_production_ticks) != 0)) {
+			i->counter = next_counter;
+			continue;
+		}
 		ProduceIndustryGoods(i);
 	}
 }
@@ -35,6 +35,9 @@
 #include "town.h"
 #include "3rdparty/cpp-btree/btree_set.h"
 #include "scope_info.h"
+#include "newgrf.h"
+#include "clear_func.h"
+#include "worker_thread.h"
 #include <array>
 #include <list>
 #include <set>
@@ -835,6 +838,63 @@ void SetupTileLoopCounts()
 	if (accumulator > 0) _tile_loop_counts[0]++;
 }
 
+/**
+ * Run the tile loop of count tiles, starting at tile, with the tile loop of clear tiles run on worker threads.
+ * The tiles which satisfy IsClearTileLoopParallelSafe only change themselves and do not use the random generator,
+ * so these are run first, in any order. The remaining tiles are then run on this thread, in tile loop order.
+ * @param tile First tile.
+ * @param count Number of tiles.
+ * @param feedback Feedback value of the LFSR.
+ * @param skip_non_flooding_water Whether to skip non-flooding water tiles.
+ * @return The next tile in the sequence.
+ */
+static TileIndex RunTileLoopWithParallelClear(TileIndex tile, uint count, uint32 feedback, bool skip_non_flooding_water)
+{
+	/* Number of clear tiles per worker chunk. */
+	static const size_t CLEAR_TILE_CHUNK_SIZE = 4096;
+
+	static std::vector<TileIndex> clear_tiles;
+	static std::vector<TileIndex> serial_tiles;
+	static std::vector<std::vector<std::pair<TileIndex, ViewportMarkDirtyFlags>>> dirty_tiles;
+
+	clear_tiles.clear();
+	serial_tiles.clear();
+	while (count--) {
+		if (!skip_non_flooding_water || !HasNonFloodingWaterTileBit(tile)) {
+			if (IsClearTileLoopParallelSafe(tile)) {
+				clear_tiles.push_back(tile);
+			} else {
+				serial_tiles.push_back(tile);
+			}
+		}
+
+		/* Get the next tile in sequence using a Galois LFSR. */
+		tile = (tile >> 1) ^ (-(int32)(tile & 1) & feedback);
+	}
+
+	dirty_tiles.resize(CeilDivT<size_t>(clear_tiles.size(), CLEAR_TILE_CHUNK_SIZE));
+	_general_worker_pool.ParallelFor(0, clear_tiles.size(), CLEAR_TILE_CHUNK_SIZE, [&](size_t begin, size_t end) {
+		std::vector<std::pair<TileIndex, ViewportMarkDirtyFlags>> &dirty = dirty_tiles[begin / CLEAR_TILE_CHUNK_SIZE];
+		for (size_t i = begin; i < end; i++) {
+			TileLoopClearParallel(clear_tiles[i], dirty);
+		}
+	});
+
+	/* Viewport invalidation is not thread-safe, so this is done here. */
+	for (auto &dirty : dirty_tiles) {
+		for (const auto &it : dirty) {
+			MarkTileDirtyByTile(it.first, it.second);
+		}
+		dirty.clear();
+	}
+
+	for (TileIndex t : serial_tiles) {
+		_tile_type_procs[GetTileType(t)]->tile_loop_proc(t);
+	}
+
+	return tile;
+}
+
 /**
  * Gradually iterate over all tiles on the map, calling their TileLoopProcs once every 256 ticks.
  */
@@ -865,11 +925,21 @@ void RunTileLoop(bool apply_day_length)
 		count--;
 	}
 
-	while (count--) {
-		_tile_type_procs[GetTileType(tile)]->tile_loop_proc(tile);
+	/* The tile loop of non-flooding water tiles does nothing except ambient sounds,
+	 * so skip these using the bitmap, to avoid fetching the tile from the tile-array. */
+	const bool skip_non_flooding_water = !HasGrfMiscBit(GMB_AMBIENT_SOUND_CALLBACK);
 
-		/* Get the next tile in sequence using a Galois LFSR. */
-		tile = (tile >> 1) ^ (-(int32)(tile & 1) & feedback);
+	if (_settings_game.economy.parallel_clear_tile_loop) {
+		tile = RunTileLoopWithParallelClear(tile, count, feedback, skip_non_flooding_water);
+	} else {
+		while (count--) {
+			if (!skip_non_flooding_water || !HasNonFloodingWaterTileBit(tile)) {
+				_tile_type_procs[GetTileType(tile)]->tile_loop_proc(tile);
+			}
+
+			/* Get the next tile in sequence using a Galois LFSR. */
+			tile = (tile >> 1) ^ (-(int32)(tile & 1) & feedback);
+		}
 	}
 
 	_cur_tileloop_tile = tile;
@@ -887,7 +957,7 @@ void RunAuxiliaryTileLoop()
 	TileIndex tile = _aux_tileloop_tile;
 
 	while (count--) {
-		if (!IsNonFloodingWaterTile(tile)) {
+		if (!HasNonFloodingWaterTileBit(tile)) {
 			FloodingBehaviour fb = GetFloodingBehaviour(tile);
 			if (fb != FLOOD_NONE) TileLoopWaterFlooding(fb, tile);
 		}
@@ -97,6 +97,10 @@ void LinkGraphJob::FinaliseJob()
 	 * the only valid job operation is to clear the LinkGraphJob pool. */
 	assert(!this->IsJobAborted());
 
+	DEBUG(linkgraph, 2, "LinkGraphJob::FinaliseJob(): id: %u, nodes: %u, init: " OTTD_PRINTF64U "us, demand: " OTTD_PRINTF64U "us, mcf1: " OTTD_PRINTF64U "us, mcf2: " OTTD_PRINTF64U "us, flowmapper: " OTTD_PRINTF64U "us",
+			this->index, this->Size(), this->stage_times[LGJTS_INIT], this->stage_times[LGJTS_DEMAND], this->stage_times[LGJTS_MCF1],
+			this->stage_times[LGJTS_MCF2], this->stage_times[LGJTS_FLOWMAPPER]);
+
 	/* Link graph has been merged into another one. */
 	if (!LinkGraph::IsValidID(this->link_graph.index)) return;
 
@@ -196,6 +200,11 @@ void LinkGraphJob::Init()
 	this->nodes.resize(size);
 	for (uint i = 0; i < size; ++i) {
 		this->nodes[i].Init(this->link_graph[i].Supply());
+		StationID st = this->link_graph[i].Station();
+		if (st >= this->station_to_node.size()) {
+			this->station_to_node.resize(st + 1);
+		}
+		this->station_to_node[st] = i;
 	}
 
 	/* Prioritize the fastest route for passengers, mail and express cargo,
@@ -14,8 +14,10 @@
 #include "../core/dyn_arena_alloc.hpp"
 #include "linkgraph.h"
 #include <vector>
+#include <algorithm>
 #include <memory>
 #include <atomic>
+#include <array>
 
 class LinkGraphJob;
 class Path;
@@ -112,6 +114,18 @@ public:
 
 	typedef std::vector<Edge> EdgeAnnotationVector;
 
+	/**
+	 * Stages of the link graph calculation, for the per-job timing breakdown.
+	 */
+	enum TimingStage {
+		LGJTS_INIT,        ///< Job initialisation.
+		LGJTS_DEMAND,      ///< Demand calculation.
+		LGJTS_MCF1,        ///< First pass of the multi-commodity flow calculation.
+		LGJTS_MCF2,        ///< Second pass of the multi-commodity flow calculation.
+		LGJTS_FLOWMAPPER,  ///< Both flow mapping passes.
+		LGJTS_END,
+	};
+
 private:
 	/**
 	 * Annotation for a link graph node.
@@ -142,9 +156,11 @@ protected:
 	DateTicks join_date_ticks;        ///< Date when the job is to be joined.
 	DateTicks start_date_ticks;       ///< Date when the job was started.
 	NodeAnnotationVector nodes;       ///< Extra node data necessary for link graph calculation.
-	EdgeAnnotationVector edges;       ///< Edge data necessary for link graph calculation.
+	EdgeAnnotationVector edges;       ///< Edge data necessary for link graph calculation, grouped by source node and sorted by destination node.
+	std::vector<NodeID> station_to_node; ///< Lookup table for getting NodeIDs from StationIDs.
 	std::atomic<bool> job_completed;  ///< Is the job still running. This is accessed by multiple threads and reads may be stale.
 	std::atomic<bool> job_aborted;    ///< Has the job been aborted. This is accessed by multiple threads and reads may be stale.
+	std::array<uint64, LGJTS_END> stage_times{}; ///< Time spent in each calculation stage, in microseconds. Only valid once the job has been joined.
 
 	void EraseFlows(NodeID from);
 	void JoinThread();
@@ -241,11 +257,19 @@ public:
 			this->node_anno.demands = demands;
 		}
 
+		/**
+		 * Get the edge annotation towards the given node.
+		 * The edges of a node are sorted by destination, see LinkGraphJob::Init.
+		 * @param to Destination node.
+		 * @return Edge annotation, or an empty edge if there is no such edge.
+		 */
 		Edge &GetEdgeTo(NodeID to)
 		{
-			for (Edge &edge : this->node_anno.edges) {
-				if (edge.To() == to) return edge;
-			}
+			span<Edge> edges = this->node_anno.edges;
+			auto it = std::lower_bound(edges.begin(), edges.end(), to, [](const Edge &edge, NodeID to) {
+				return edge.To() < to;
+			});
+			if (it != edges.end() && it->To() == to) return *it;
 
 			static Edge empty_edge = {};
 			return empty_edge;
@@ -292,6 +316,14 @@ public:
 	 */
 	inline void AbortJob() { this->job_aborted.store(true, std::memory_order_release); }
 
+	/**
+	 * Get the time spent in a calculation stage.
+	 * This is only valid once the job has been joined.
+	 * @param stage Calculation stage.
+	 * @return Time spent in microseconds.
+	 */
+	inline uint64 GetStageTime(TimingStage stage) const { return this->stage_times[stage]; }
+
 	/**
 	 * Check if job is supposed to be finished.
 	 * @param tick_offset Optional number of ticks to add to the current date
@@ -317,6 +349,12 @@ public:
 	 */
 	inline void ShiftJoinDate(int interval) { this->join_date_ticks += interval * DAY_TICKS; }
 
+	/**
+	 * Get the lookup table for getting NodeIDs from StationIDs.
+	 * @return Lookup table, indexed by StationID.
+	 */
+	inline const std::vector<NodeID> &StationToNode() const { return this->station_to_node; }
+
 	/**
 	 * Get the link graph settings for this component.
 	 * @return Settings.
@@ -363,13 +401,15 @@ public:
 
 /**
  * A leg of a path in the link graph. Paths can form trees by being "forked".
+ * Paths are allocated from LinkGraphJob::path_allocator, which releases the memory without
+ * running destructors, so this class and its subclasses must stay trivially destructible.
+ * This also keeps paths free of a vtable pointer.
  */
 class Path {
 public:
 	static Path *invalid_path;
 
 	Path(NodeID n, bool source = false);
-	virtual ~Path() = default;
 
 	/** Get the node this leg passes. */
 	inline NodeID GetNode() const { return this->node; }
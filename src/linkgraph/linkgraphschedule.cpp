@@ -16,7 +16,9 @@
 #include "../framerate_type.h"
 #include "../command_func.h"
 #include "../network/network.h"
+#include "../worker_thread.h"
 #include <algorithm>
+#include <chrono>
 
 #include "../safeguards.h"
 
@@ -27,6 +29,25 @@
  */
 /* static */ LinkGraphSchedule LinkGraphSchedule::instance;
 
+/**
+ * Worker pool used to run the jobs of a LinkGraphJobGroup concurrently.
+ * This is not the general worker pool, as link graph jobs run in the background for many ticks.
+ * On the general worker pool they would hold its workers for that long, and work which the game loop
+ * waits for within a tick, e.g. ParallelFor, would then run on the game thread alone.
+ * It is limited to half of the CPUs, to leave the rest for the game thread and the general worker pool.
+ */
+WorkerThreadPool _link_graph_worker_pool;
+
+/** Timing stage of each of the handlers in LinkGraphSchedule::handlers. */
+static const LinkGraphJob::TimingStage _link_graph_handler_stages[] = {
+	LinkGraphJob::LGJTS_INIT,
+	LinkGraphJob::LGJTS_DEMAND,
+	LinkGraphJob::LGJTS_MCF1,
+	LinkGraphJob::LGJTS_FLOWMAPPER,
+	LinkGraphJob::LGJTS_MCF2,
+	LinkGraphJob::LGJTS_FLOWMAPPER,
+};
+
 /**
  * Start the next job(s) in the schedule.
  *
@@ -152,9 +173,14 @@ void LinkGraphSchedule::JoinNext()
  */
 /* static */ void LinkGraphSchedule::Run(LinkGraphJob *job)
 {
+	static_assert(lengthof(_link_graph_handler_stages) == lengthof(instance.handlers));
+
+	job->stage_times.fill(0);
 	for (uint i = 0; i < lengthof(instance.handlers); ++i) {
 		if (job->IsJobAborted()) return;
+		auto start = std::chrono::steady_clock::now();
 		instance.handlers[i]->Run(*job);
+		job->stage_times[_link_graph_handler_stages[i]] += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
 	}
 
 	/*
@@ -262,14 +288,18 @@ void LinkGraphJobGroup::JoinThread()
 /**
  * Run all jobs for the given LinkGraphJobGroup. This method is tailored to
  * ThreadObject::New.
+ * The jobs of the group are independent of each other, so they are run concurrently
+ * on the link graph worker pool, with the group thread also taking part.
  * @param j Pointer to a LinkGraphJobGroup.
  */
 /* static */ void LinkGraphJobGroup::Run(void *group)
 {
 	LinkGraphJobGroup *job_group = (LinkGraphJobGroup *)group;
-	for (LinkGraphJob *job : job_group->jobs) {
-		LinkGraphSchedule::Run(job);
-	}
+	_link_graph_worker_pool.ParallelFor(0, job_group->jobs.size(), 1, [job_group](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			LinkGraphSchedule::Run(job_group->jobs[i]);
+		}
+	});
 }
 
 /* static */ void LinkGraphJobGroup::ExecuteJobSet(std::vector<JobInfo> jobs) {
@@ -112,6 +112,8 @@ public:
 	static void ExecuteJobSet(std::vector<JobInfo> jobs);
 };
 
+extern struct WorkerThreadPool _link_graph_worker_pool;
+
 void StateGameLoop_LinkGraphPauseControl();
 void AfterLoad_LinkGraphPauseControl();
 
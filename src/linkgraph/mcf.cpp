@@ -166,7 +166,7 @@ private:
 	LinkGraphJob &job; ///< Link graph job we're working with.
 
 	/** Lookup table for getting NodeIDs from StationIDs. */
-	std::vector<NodeID> station_to_node;
+	const std::vector<NodeID> &station_to_node;
 
 	/** Current iterator in the shares map. */
 	FlowStat::const_iterator it;
@@ -179,16 +179,7 @@ public:
 	 * Constructor.
 	 * @param job Link graph job to work with.
 	 */
-	FlowEdgeIterator(LinkGraphJob &job) : job(job)
-	{
-		for (NodeID i = 0; i < job.Size(); ++i) {
-			StationID st = job[i].Station();
-			if (st >= this->station_to_node.size()) {
-				this->station_to_node.resize(st + 1);
-			}
-			this->station_to_node[st] = i;
-		}
-	}
+	FlowEdgeIterator(LinkGraphJob &job) : job(job), station_to_node(job.StationToNode()) {}
 
 	/**
 	 * Setup the node to retrieve edges from.
@@ -292,6 +283,8 @@ bool CapacityAnnotation::IsBetter(const CapacityAnnotation *base, uint cap,
 template<class Tannotation, class Tedge_iterator>
 void MultiCommodityFlow::Dijkstra(NodeID source_node, PathVector &paths)
 {
+	static_assert(std::is_trivially_destructible_v<Tannotation>, "Paths are freed without running their destructors");
+
 	typedef btree::btree_set<AnnoSetItem<Tannotation>, typename Tannotation::Comparator> AnnoSet;
 	AnnoSet annos = AnnoSet(typename Tannotation::Comparator());
 	Tedge_iterator iter(this->job);
@@ -34,6 +34,7 @@ uint _map_tile_mask; ///< _map_size - 1 (to mask the mapsize)
 
 Tile *_m = nullptr;          ///< Tiles of the map
 TileExtended *_me = nullptr; ///< Extended Tiles of the map
+uint64 *_m_non_flooding_water = nullptr; ///< Non-flooding water tile bitmap of the map
 
 /**
  * Validates whether a map with the given dimension is valid
@@ -78,9 +79,23 @@ void AllocateMap(uint size_x, uint size_y)
 
 	free(_m);
 	free(_me);
+	free(_m_non_flooding_water);
 
 	_m = CallocT<Tile>(_map_size);
 	_me = CallocT<TileExtended>(_map_size);
+	_m_non_flooding_water = CallocT<uint64>(_map_size / 64);
+}
+
+/**
+ * Rebuild the non-flooding water tile bitmap from the tile-array.
+ * This is necessary after the tile-array has been written to directly, e.g. when loading a savegame.
+ */
+void RebuildNonFloodingWaterTileBits()
+{
+	const TileIndex map_size = MapSize();
+	for (TileIndex t = 0; t < map_size; t++) {
+		SetNonFloodingWaterTileBit(t, IsNonFloodingWaterTile(t));
+	}
 }
 
 
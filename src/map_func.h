@@ -11,6 +11,7 @@
 #define MAP_FUNC_H
 
 #include "core/math_func.hpp"
+#include "core/bitmath_func.hpp"
 #include "tile_type.h"
 #include "map_type.h"
 #include "direction_func.h"
@@ -41,9 +42,39 @@ extern Tile *_m;
  */
 extern TileExtended *_me;
 
+/**
+ * Pointer to the non-flooding water tile bitmap.
+ *
+ * This holds one bit per tile, which is set for tiles where IsNonFloodingWaterTile is true.
+ * It allows the tile loops to skip idle water tiles without touching the tile-array.
+ */
+extern uint64 *_m_non_flooding_water;
+
 bool ValidateMapSize(uint size_x, uint size_y);
 void AllocateMap(uint size_x, uint size_y);
 
+/**
+ * Check whether the bit for the given tile is set in the non-flooding water tile bitmap.
+ * @param t the tile to check
+ * @return whether the tile is marked as a non-flooding water tile
+ */
+static inline bool HasNonFloodingWaterTileBit(TileIndex t)
+{
+	return HasBit(_m_non_flooding_water[t / 64], t % 64);
+}
+
+/**
+ * Set or clear the bit for the given tile in the non-flooding water tile bitmap.
+ * @param t the tile to change
+ * @param b whether to set or clear the bit
+ */
+static inline void SetNonFloodingWaterTileBit(TileIndex t, bool b)
+{
+	SB(_m_non_flooding_water[t / 64], t % 64, 1, b ? 1 : 0);
+}
+
+void RebuildNonFloodingWaterTileBits();
+
 /**
  * Logarithm of the map size along the X side.
  * @note try to avoid using this one
@@ -167,6 +167,7 @@ void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settin
 
 	FreeSignalPrograms();
 	FreeSignalDependencies();
+	ClearSignalSegmentCache();
 
 	ClearAllSignalSpeedRestrictions();
 
@@ -131,6 +131,12 @@ typedef unsigned long in_addr_t;
 #		define FD_SETSIZE 512
 #   endif
 
+/* Linux has epoll, which the servers use to poll their sockets without rebuilding fd_sets. */
+#   if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#		include <sys/epoll.h>
+#		define HAVE_EPOLL
+#   endif
+
 #endif /* UNIX */
 
 /* OS/2 stuff */
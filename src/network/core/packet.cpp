@@ -18,6 +18,66 @@
 
 #include "../../safeguards.h"
 
+/** Maximum number of buffers in the packet buffer pool. */
+static const size_t PACKET_BUFFER_POOL_SIZE = 256;
+/** Maximum capacity of a buffer for it to be kept in the packet buffer pool. */
+static const size_t PACKET_BUFFER_POOL_MAX_CAPACITY = 4096;
+
+/** Pool of the buffers of destroyed packets of the current thread, these are reused for new packets to avoid allocating a buffer for each packet. */
+static thread_local std::vector<std::vector<byte>> *_packet_buffer_pool = nullptr;
+/** Whether the packet buffer pool of the current thread has been destroyed, packets may still be destroyed afterwards when exiting. */
+static thread_local bool _packet_buffer_pool_destroyed = false;
+
+/** Owner of the packet buffer pool of a thread. */
+struct PacketBufferPoolOwner {
+	std::vector<std::vector<byte>> buffers;
+
+	PacketBufferPoolOwner() { _packet_buffer_pool = &this->buffers; }
+
+	~PacketBufferPoolOwner()
+	{
+		_packet_buffer_pool = nullptr;
+		_packet_buffer_pool_destroyed = true;
+	}
+};
+
+/**
+ * Get the packet buffer pool of the current thread.
+ * @return The pool, or nullptr if it has already been destroyed.
+ */
+static std::vector<std::vector<byte>> *GetPacketBufferPool()
+{
+	if (_packet_buffer_pool == nullptr && !_packet_buffer_pool_destroyed) {
+		static thread_local PacketBufferPoolOwner owner;
+	}
+	return _packet_buffer_pool;
+}
+
+/**
+ * Take a buffer from the packet buffer pool, if there is one.
+ * @param[out] buffer The buffer to replace with a buffer from the pool.
+ */
+static void AcquirePacketBuffer(std::vector<byte> &buffer)
+{
+	std::vector<std::vector<byte>> *pool = GetPacketBufferPool();
+	if (pool == nullptr || pool->empty()) return;
+
+	buffer = std::move(pool->back());
+	pool->pop_back();
+}
+
+Packet::~Packet()
+{
+	const size_t capacity = this->buffer.capacity();
+	if (capacity == 0 || capacity > PACKET_BUFFER_POOL_MAX_CAPACITY) return;
+
+	std::vector<std::vector<byte>> *pool = GetPacketBufferPool();
+	if (pool == nullptr || pool->size() >= PACKET_BUFFER_POOL_SIZE) return;
+
+	this->buffer.clear();
+	pool->push_back(std::move(this->buffer));
+}
+
 /**
  * Create a packet that is used to read from a network socket.
  * @param cs                The socket handler associated with the socket we are reading from.
@@ -35,6 +95,7 @@ Packet::Packet(NetworkSocketHandler *cs, size_t limit, size_t initial_read_size)
 	assert(cs != nullptr);
 
 	this->cs = cs;
+	AcquirePacketBuffer(this->buffer);
 	this->buffer.resize(initial_read_size);
 }
 
@@ -48,6 +109,7 @@ Packet::Packet(NetworkSocketHandler *cs, size_t limit, size_t initial_read_size)
  */
 Packet::Packet(PacketType type, size_t limit) : pos(0), limit(limit), cs(nullptr)
 {
+	AcquirePacketBuffer(this->buffer);
 	this->ResetState(type);
 }
 
@@ -72,7 +134,8 @@ void Packet::PrepareToSend()
 	this->buffer[1] = GB(this->Size(), 8, 8);
 
 	this->pos  = 0; // We start reading from here
-	this->buffer.shrink_to_fit();
+	/* Small buffers are kept as is, so that they can be reused via the packet buffer pool. */
+	if (this->buffer.capacity() > PACKET_BUFFER_POOL_MAX_CAPACITY) this->buffer.shrink_to_fit();
 }
 
 /**
@@ -85,6 +148,12 @@ bool Packet::CanWriteToPacket(size_t bytes_to_write)
 	return this->Size() + bytes_to_write <= this->limit;
 }
 
+void Packet::WriteAtOffset_uint8(size_t offset, uint8 data)
+{
+	assert(offset < this->buffer.size());
+	this->buffer[offset] = data;
+}
+
 void Packet::WriteAtOffset_uint16(size_t offset, uint16 data)
 {
 	assert(offset + 1 < this->buffer.size());
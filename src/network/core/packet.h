@@ -20,6 +20,7 @@
 #include <string>
 #include <functional>
 #include <limits>
+#include <memory>
 
 typedef uint16 PacketSize; ///< Size of the whole packet.
 typedef uint8  PacketType; ///< Identifier for the packet
@@ -58,6 +59,11 @@ private:
 public:
 	Packet(NetworkSocketHandler *cs, size_t limit, size_t initial_read_size = sizeof(PacketSize));
 	Packet(PacketType type, size_t limit = COMPAT_MTU);
+	Packet(const Packet &) = delete;
+	Packet(Packet &&) = default;
+	Packet &operator=(const Packet &) = delete;
+	Packet &operator=(Packet &&) = default;
+	~Packet();
 
 	void ResetState(PacketType type);
 
@@ -74,6 +80,7 @@ public:
 
 	bool CanWriteToPacket(size_t bytes_to_write);
 
+	void WriteAtOffset_uint8(size_t offset, uint8);
 	void WriteAtOffset_uint16(size_t offset, uint16);
 
 	/* Reading/receiving of packets */
@@ -191,6 +198,17 @@ public:
 	NetworkSocketHandler *GetParentSocket() { return this->cs; }
 };
 
+/**
+ * Prepare a packet for sending, such that it can be queued to any number of sockets.
+ * @param p The packet, ownership is taken.
+ * @return The packet, shared by all sockets it is queued to.
+ */
+inline std::shared_ptr<const Packet> PrepareSharedPacket(Packet *p)
+{
+	p->PrepareToSend();
+	return std::shared_ptr<const Packet>(p);
+}
+
 struct SubPacketDeserialiser : public BufferDeserialisationHelper<SubPacketDeserialiser> {
 	NetworkSocketHandler *cs;
 	const byte *data;
@@ -14,6 +14,13 @@
 
 #include "tcp.h"
 
+#if defined(UNIX) && !defined(__OS2__) && !defined(__EMSCRIPTEN__)
+#	include <sys/uio.h>
+#	include <limits.h>
+/** Send the queued packets using writev, to send multiple packets in one call. */
+#	define WITH_NETWORK_WRITEV
+#endif
+
 #include "../../safeguards.h"
 
 /**
@@ -38,6 +45,7 @@ NetworkTCPSocketHandler::~NetworkTCPSocketHandler()
 void NetworkTCPSocketHandler::EmptyPacketQueue()
 {
 	this->packet_queue.clear();
+	this->packet_queue_sent = 0;
 	this->packet_recv.reset();
 }
 
@@ -83,6 +91,18 @@ void NetworkTCPSocketHandler::SendPacket(std::unique_ptr<Packet> packet)
 	this->packet_queue.push_back(std::move(packet));
 }
 
+/**
+ * This function puts a packet, which may also be queued to other sockets, in the send-queue.
+ * This avoids creating the same packet for each socket, e.g. when broadcasting to all clients.
+ * @param packet the packet to send, this must have been prepared using PrepareSharedPacket
+ */
+void NetworkTCPSocketHandler::SendSharedPacket(std::shared_ptr<const Packet> packet)
+{
+	assert(packet != nullptr);
+
+	this->packet_queue.push_back(std::move(packet));
+}
+
 /**
  * This function puts the packet in the send-queue and it is send as
  * soon as possible. This is the next tick, or maybe one tick later
@@ -94,12 +114,13 @@ void NetworkTCPSocketHandler::SendPrependPacket(std::unique_ptr<Packet> packet,
 	assert(packet != nullptr);
 
 	packet->PrepareToSend();
+	std::shared_ptr<const Packet> shared_packet = std::move(packet);
 
 	if (queue_after_packet_type >= 0) {
 		for (auto iter = this->packet_queue.begin(); iter != this->packet_queue.end(); ++iter) {
 			if ((*iter)->GetPacketType() == queue_after_packet_type) {
 				++iter;
-				this->packet_queue.insert(iter, std::move(packet));
+				this->packet_queue.insert(iter, std::move(shared_packet));
 				return;
 			}
 		}
@@ -109,9 +130,43 @@ void NetworkTCPSocketHandler::SendPrependPacket(std::unique_ptr<Packet> packet,
 	 * If the queue is non-empty, swap packet with the first packet in the queue.
 	 * The insert the packet (either the incoming packet or the previous first packet) at the front. */
 	if (!this->packet_queue.empty()) {
-		packet.swap(this->packet_queue.front());
+		shared_packet.swap(this->packet_queue.front());
 	}
-	this->packet_queue.push_front(std::move(packet));
+	this->packet_queue.push_front(std::move(shared_packet));
+}
+
+/**
+ * Send (part of) the data of the queued packets.
+ * Where possible, multiple packets are sent in a single call.
+ * @param[out] attempted The number of bytes which were attempted to be sent.
+ * @return The number of bytes sent, or -1 on error.
+ */
+ssize_t NetworkTCPSocketHandler::SendQueuedData(size_t &attempted)
+{
+#ifdef WITH_NETWORK_WRITEV
+	/** Maximum number of packets to send in one call. */
+	static constexpr int MAX_PACKETS_PER_CALL = 64;
+
+	/* IOV_MAX is not necessarily a compile-time constant, so only use it to limit the count. */
+	const int max_count = std::min<int>(MAX_PACKETS_PER_CALL, IOV_MAX);
+	struct iovec iov[MAX_PACKETS_PER_CALL];
+	int count = 0;
+	size_t offset = this->packet_queue_sent;
+	attempted = 0;
+	for (const auto &p : this->packet_queue) {
+		if (count == max_count) break;
+		iov[count].iov_base = const_cast<byte *>(p->GetBufferData() + offset);
+		iov[count].iov_len = p->Size() - offset;
+		attempted += iov[count].iov_len;
+		offset = 0;
+		count++;
+	}
+	return writev(this->sock, iov, count);
+#else
+	const Packet *p = this->packet_queue.front().get();
+	attempted = p->Size() - this->packet_queue_sent;
+	return send(this->sock, reinterpret_cast<const char *>(p->GetBufferData() + this->packet_queue_sent), static_cast<int>(attempted), 0);
+#endif
 }
 
 /**
@@ -133,8 +188,8 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 	if (!this->IsConnected()) return SPS_CLOSED;
 
 	while (!this->packet_queue.empty()) {
-		Packet *p = this->packet_queue.front().get();
-		res = p->TransferOut<int>(send, this->sock, 0);
+		size_t attempted;
+		res = this->SendQueuedData(attempted);
 		if (res == -1) {
 			NetworkError err = NetworkError::GetLast();
 			if (!err.WouldBlock()) {
@@ -145,6 +200,8 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 				}
 				return SPS_CLOSED;
 			}
+			/* The send buffer is full, wait until the socket is reported writable again. */
+			this->writable = false;
 			return SPS_PARTLY_SENT;
 		}
 		if (res == 0) {
@@ -153,14 +210,24 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 			return SPS_CLOSED;
 		}
 
-		/* Is this packet sent? */
-		if (p->RemainingBytesToTransfer() == 0) {
+		/* Remove the packets which have been sent completely. */
+		size_t sent = (size_t)res;
+		while (sent > 0) {
+			const Packet &p = *this->packet_queue.front();
+			const size_t remaining = p.Size() - this->packet_queue_sent;
+			if (sent < remaining) {
+				this->packet_queue_sent += sent;
+				break;
+			}
+
 			/* Go to the next packet */
-			if (_debug_net_level >= 5) this->LogSentPacket(*p);
+			sent -= remaining;
+			if (_debug_net_level >= 5) this->LogSentPacket(p);
 			this->packet_queue.pop_front();
-		} else {
-			return SPS_PARTLY_SENT;
+			this->packet_queue_sent = 0;
 		}
+
+		if ((size_t)res < attempted) return SPS_PARTLY_SENT;
 	}
 
 	return SPS_ALL_SENT;
@@ -195,6 +262,7 @@ std::unique_ptr<Packet> NetworkTCPSocketHandler::ReceivePacket()
 					return nullptr;
 				}
 				/* Connection would block, so stop for now */
+				this->readable = false;
 				return nullptr;
 			}
 			if (res == 0) {
@@ -224,6 +292,7 @@ std::unique_ptr<Packet> NetworkTCPSocketHandler::ReceivePacket()
 				return nullptr;
 			}
 			/* Connection would block */
+			this->readable = false;
 			return nullptr;
 		}
 		if (res == 0) {
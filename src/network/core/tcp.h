@@ -36,13 +36,16 @@ enum SendPacketsState {
 /** Base socket handler for all TCP sockets */
 class NetworkTCPSocketHandler : public NetworkSocketHandler {
 private:
-	std::deque<std::unique_ptr<Packet>> packet_queue; ///< Packets that are awaiting delivery
-	std::unique_ptr<Packet> packet_recv;              ///< Partially received packet
+	std::deque<std::shared_ptr<const Packet>> packet_queue; ///< Packets that are awaiting delivery, these may be shared with other sockets
+	size_t packet_queue_sent = 0;                           ///< Number of bytes of the first packet in packet_queue which have been sent
+	std::unique_ptr<Packet> packet_recv;                    ///< Partially received packet
 
 	void EmptyPacketQueue();
+	ssize_t SendQueuedData(size_t &attempted);
 public:
 	SOCKET sock;              ///< The socket currently connected to
 	bool writable;            ///< Can we write to this socket?
+	bool readable = false;    ///< May there be more to read from this socket? Only used for edge-triggered polling.
 
 	/**
 	 * Whether this socket is currently bound to a socket.
@@ -54,6 +57,7 @@ public:
 	void CloseSocket();
 
 	void SendPacket(std::unique_ptr<Packet> packet);
+	void SendSharedPacket(std::shared_ptr<const Packet> packet);
 	void SendPrependPacket(std::unique_ptr<Packet> packet, int queue_after_packet_type);
 
 	void SendPacket(Packet *packet)
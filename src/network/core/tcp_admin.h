@@ -61,6 +61,9 @@ enum PacketAdminType {
 	ADMIN_PACKET_SERVER_RCON_END,        ///< The server indicates that the remote console command has completed.
 	ADMIN_PACKET_SERVER_PONG,            ///< The server replies to a ping request from the admin.
 
+	/* Packets from 200 on are specific to this patch pack, so that packets added upstream don't collide with them. */
+	ADMIN_PACKET_SERVER_STATS_DELTA = 200, ///< The server gives the admin the changes of company and station statistics.
+
 	INVALID_ADMIN_PACKET = 0xFF,         ///< An invalid marker for admin packets.
 };
 
@@ -83,9 +86,43 @@ enum AdminUpdateType {
 	ADMIN_UPDATE_CMD_NAMES,       ///< The admin would like a list of all DoCommand names.
 	ADMIN_UPDATE_CMD_LOGGING,     ///< The admin would like to have DoCommand information.
 	ADMIN_UPDATE_GAMESCRIPT,      ///< The admin would like to have gamescript messages.
+	ADMIN_UPDATE_STATS_DELTA,     ///< Updates about the changes of company and station statistics.
 	ADMIN_UPDATE_END,             ///< Must ALWAYS be on the end of this list!! (period)
+
+	ADMIN_UPDATE_PATCH_PACK_FIRST = ADMIN_UPDATE_STATS_DELTA, ///< First update type which is specific to this patch pack.
 };
 
+/**
+ * Update types from #ADMIN_UPDATE_PATCH_PACK_FIRST on are specific to this patch pack.
+ * On the wire these are numbered from this value on, so that update types added upstream don't collide with them.
+ */
+static const uint8 ADMIN_UPDATE_PATCH_PACK_WIRE_BASE = 0x80;
+
+/**
+ * Get the number of an update type on the wire.
+ * @param type The update type.
+ * @return The number on the wire.
+ */
+inline uint16 GetAdminUpdateTypeWireValue(AdminUpdateType type)
+{
+	if (type < ADMIN_UPDATE_PATCH_PACK_FIRST) return type;
+	return ADMIN_UPDATE_PATCH_PACK_WIRE_BASE + (type - ADMIN_UPDATE_PATCH_PACK_FIRST);
+}
+
+/**
+ * Get the update type of a number on the wire.
+ * @param value The number on the wire.
+ * @return The update type, or #ADMIN_UPDATE_END if it is not known.
+ */
+inline AdminUpdateType GetAdminUpdateTypeFromWireValue(uint16 value)
+{
+	if (value < ADMIN_UPDATE_PATCH_PACK_FIRST) return (AdminUpdateType)value;
+	if (value >= ADMIN_UPDATE_PATCH_PACK_WIRE_BASE && value - ADMIN_UPDATE_PATCH_PACK_WIRE_BASE < ADMIN_UPDATE_END - ADMIN_UPDATE_PATCH_PACK_FIRST) {
+		return (AdminUpdateType)(ADMIN_UPDATE_PATCH_PACK_FIRST + (value - ADMIN_UPDATE_PATCH_PACK_WIRE_BASE));
+	}
+	return ADMIN_UPDATE_END;
+}
+
 /** Update frequencies an admin can register. */
 enum AdminUpdateFrequency {
 	ADMIN_FREQUENCY_POLL      = 0x01, ///< The admin can poll this.
@@ -98,6 +135,23 @@ enum AdminUpdateFrequency {
 };
 DECLARE_ENUM_AS_BIT_SET(AdminUpdateFrequency)
 
+/** Flags of #ADMIN_PACKET_SERVER_STATS_DELTA packets. */
+enum AdminStatsDeltaFlags {
+	ADMIN_SDF_RESET = 0x01, ///< The admin must discard all records it knows of before applying this update, this is only set in the first packet of an update.
+	ADMIN_SDF_LAST  = 0x02, ///< This is the last packet of this update.
+};
+DECLARE_ENUM_AS_BIT_SET(AdminStatsDeltaFlags)
+
+/** Types of records in #ADMIN_PACKET_SERVER_STATS_DELTA packets. */
+enum AdminStatsDeltaRecordType {
+	ADMIN_SDR_COMPANY,       ///< Statistics of a company.
+	ADMIN_SDR_STATION,       ///< Generic information of a station.
+	ADMIN_SDR_STATION_CARGO, ///< Statistics of a cargo at a station.
+	ADMIN_SDR_END,           ///< Must ALWAYS be on the end of this list!! (period)
+
+	ADMIN_SDR_REMOVED = 0x80, ///< Flag of a record type, the record was removed.
+};
+
 /** Reasons for removing a company - communicated to admins. */
 enum AdminCompanyRemoveReason {
 	ADMIN_CRR_MANUAL,    ///< The company is manually removed.
@@ -481,6 +535,21 @@ protected:
 	 */
 	virtual NetworkRecvStatus Receive_SERVER_PONG(Packet *p);
 
+	/**
+	 * Send the changes of the company and station statistics since the previous update to the admin.
+	 * An update may be split over multiple packets, see docs/admin_network.md for the format of the records.
+	 * uint8   Flags (see #AdminStatsDeltaFlags).
+	 * uint32  Current game date.
+	 * The records follow until the end of the packet:
+	 * uint8   Record type (see #AdminStatsDeltaRecordType), with #ADMIN_SDR_REMOVED set if the record was removed.
+	 * varies  Record ID.
+	 * varuint Bitmask of the included fields, only if the record was not removed.
+	 * varint  Value of each included field, in order, only if the record was not removed.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_STATS_DELTA(Packet *p);
+
 	/**
 	 * Notify the admin connection that the rcon command has finished.
 	 * string The command as requested by the admin connection.
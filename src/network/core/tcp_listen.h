@@ -29,6 +29,123 @@ class TCPListenHandler {
 	/** List of sockets we listen on. */
 	static SocketList sockets;
 
+#ifdef HAVE_EPOLL
+	/** Pool index used in the epoll keys of the sockets we listen on. */
+	static const uint32 EPOLL_LISTENER_INDEX = UINT32_MAX;
+	/** Maximum number of events to fetch per epoll_wait call. */
+	static const int EPOLL_MAX_EVENTS = 256;
+
+	/** The epoll instance all sockets are registered with, or -1 when select() is used. */
+	static int epoll_fd;
+	/** Epoll keys of the sockets which may have more to read. */
+	static std::vector<uint64> epoll_read_pending;
+
+	/**
+	 * Get the key of a socket, this is registered as the data of its epoll events.
+	 * @param index The pool index of the socket handler, or EPOLL_LISTENER_INDEX.
+	 * @param s The socket.
+	 * @return The key.
+	 */
+	static uint64 GetEpollKey(uint32 index, SOCKET s)
+	{
+		return ((uint64)index << 32) | (uint32)s;
+	}
+
+	/**
+	 * Get the socket handler of a key.
+	 * Handlers may be deleted, or their pool slot and socket reused, while their events are pending.
+	 * A key therefore only resolves when the handler at its index still uses its socket.
+	 * @param key The key.
+	 * @return The socket handler, or nullptr if there is none.
+	 */
+	static Tsocket *GetEpollSocket(uint64 key)
+	{
+		Tsocket *cs = Tsocket::GetIfValid((size_t)(key >> 32));
+		if (cs == nullptr || cs->sock != (SOCKET)(uint32)key) return nullptr;
+		return cs;
+	}
+
+	/**
+	 * Register a socket with the epoll instance.
+	 * @param s The socket.
+	 * @param key The key of the socket.
+	 * @param events The events to register for.
+	 * @return true if the socket was registered.
+	 */
+	static bool EpollAdd(SOCKET s, uint64 key, uint32 events)
+	{
+		struct epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = events;
+		event.data.u64 = key;
+		if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, s, &event) == 0) return true;
+
+		DEBUG(net, 0, "[%s] epoll_ctl failed, falling back to select(): %s", Tsocket::GetName(), NetworkError::GetLast().AsString());
+		CloseEpoll();
+		return false;
+	}
+
+	/** Close the epoll instance, after which the sockets are polled with select(). */
+	static void CloseEpoll()
+	{
+		if (epoll_fd == -1) return;
+		close(epoll_fd);
+		epoll_fd = -1;
+		epoll_read_pending.clear();
+	}
+
+	/**
+	 * Handle the receiving of packets, using epoll.
+	 * The sockets are registered edge-triggered, so events are only reported when new data arrives or send
+	 * buffer space becomes available. Sockets therefore remain marked readable until a read would block,
+	 * and writable until a send would block.
+	 * @return true if everything went okay.
+	 */
+	static bool ReceiveEpoll()
+	{
+		struct epoll_event events[EPOLL_MAX_EVENTS];
+		int n;
+		do {
+			n = epoll_wait(epoll_fd, events, EPOLL_MAX_EVENTS, 0); // don't block at all.
+			if (n < 0) return false;
+
+			for (int i = 0; i < n; i++) {
+				const uint64 key = events[i].data.u64;
+				if ((uint32)(key >> 32) == EPOLL_LISTENER_INDEX) {
+					AcceptClient((SOCKET)(uint32)key);
+					if (epoll_fd == -1) return _networking;
+					continue;
+				}
+
+				Tsocket *cs = GetEpollSocket(key);
+				if (cs == nullptr) continue;
+				if (events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) cs->writable = true;
+				if ((events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP)) && !cs->readable) {
+					cs->readable = true;
+					epoll_read_pending.push_back(key);
+				}
+			}
+		} while (n == EPOLL_MAX_EVENTS);
+
+		/* Read stuff from clients, those which stopped reading before it would block are read again next time. */
+		size_t keep = 0;
+		for (size_t i = 0; i < epoll_read_pending.size(); i++) {
+			const uint64 key = epoll_read_pending[i];
+			Tsocket *cs = GetEpollSocket(key);
+			if (cs == nullptr) continue;
+
+			cs->ReceivePackets();
+
+			/* Receiving may have closed and deleted the socket handler. */
+			cs = GetEpollSocket(key);
+			if (cs != nullptr && cs->readable) epoll_read_pending[keep++] = key;
+		}
+		epoll_read_pending.resize(keep);
+
+		return _networking;
+	}
+#endif /* HAVE_EPOLL */
+
 public:
 	static bool ValidateClient(SOCKET s, NetworkAddress &address)
 	{
@@ -100,6 +217,10 @@ public:
 	 */
 	static bool Receive()
 	{
+#ifdef HAVE_EPOLL
+		if (epoll_fd != -1) return ReceiveEpoll();
+#endif
+
 		fd_set read_fd, write_fd;
 		struct timeval tv;
 
@@ -157,9 +278,33 @@ public:
 			return false;
 		}
 
+#ifdef HAVE_EPOLL
+		assert(epoll_fd == -1);
+		epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+		if (epoll_fd == -1) {
+			DEBUG(net, 0, "[%s] epoll_create1 failed, falling back to select(): %s", Tsocket::GetName(), NetworkError::GetLast().AsString());
+		} else {
+			for (auto &s : sockets) {
+				if (!EpollAdd(s.first, GetEpollKey(EPOLL_LISTENER_INDEX, s.first), EPOLLIN)) break;
+			}
+		}
+#endif
+
 		return true;
 	}
 
+	/**
+	 * Register a newly accepted socket, so it is polled for receiving and sending.
+	 * @param cs The socket handler of the new connection.
+	 */
+	static void RegisterSocket(Tsocket *cs)
+	{
+#ifdef HAVE_EPOLL
+		if (epoll_fd == -1) return;
+		EpollAdd(cs->sock, GetEpollKey((uint32)cs->index, cs->sock), EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET);
+#endif
+	}
+
 	/** Close the sockets we're listening on. */
 	static void CloseListeners()
 	{
@@ -167,10 +312,17 @@ public:
 			closesocket(s.first);
 		}
 		sockets.clear();
+#ifdef HAVE_EPOLL
+		CloseEpoll();
+#endif
 		DEBUG(net, 5, "[%s] Closed listeners", Tsocket::GetName());
 	}
 };
 
 template <class Tsocket, PacketType Tfull_packet, PacketType Tban_packet> SocketList TCPListenHandler<Tsocket, Tfull_packet, Tban_packet>::sockets;
+#ifdef HAVE_EPOLL
+template <class Tsocket, PacketType Tfull_packet, PacketType Tban_packet> int TCPListenHandler<Tsocket, Tfull_packet, Tban_packet>::epoll_fd = -1;
+template <class Tsocket, PacketType Tfull_packet, PacketType Tban_packet> std::vector<uint64> TCPListenHandler<Tsocket, Tfull_packet, Tban_packet>::epoll_read_pending;
+#endif
 
 #endif /* NETWORK_CORE_TCP_LISTEN_H */
@@ -620,6 +620,7 @@ NetworkAddress ParseConnectionString(const std::string &connection_string, uint1
 
 	ServerNetworkGameSocketHandler *cs = new ServerNetworkGameSocketHandler(s);
 	cs->client_address = address; // Save the IP of the client
+	ServerNetworkGameSocketHandler::RegisterSocket(cs);
 
 	InvalidateWindowData(WC_CLIENT_LIST, 0);
 }
@@ -669,6 +670,7 @@ void NetworkClose(bool close_admins)
 	_network_server = false;
 
 	NetworkFreeLocalCommandQueue();
+	NetworkServerResetMapSnapshot();
 
 	delete[] _network_company_states;
 	_network_company_states = nullptr;
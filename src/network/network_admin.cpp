@@ -19,6 +19,7 @@
 #include "../console_func.h"
 #include "../core/pool_func.hpp"
 #include "../map_func.h"
+#include "../station_base.h"
 #include "../rev.h"
 #include "../game/game.hpp"
 
@@ -53,6 +54,7 @@ static const AdminUpdateFrequency _admin_update_type_frequencies[] = {
 	ADMIN_FREQUENCY_POLL,                                                                                                                                  ///< ADMIN_UPDATE_CMD_NAMES
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_CMD_LOGGING
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_GAMESCRIPT
+	ADMIN_FREQUENCY_POLL | ADMIN_FREQUENCY_DAILY | ADMIN_FREQUENCY_WEEKLY | ADMIN_FREQUENCY_MONTHLY | ADMIN_FREQUENCY_QUARTERLY | ADMIN_FREQUENCY_ANUALLY, ///< ADMIN_UPDATE_STATS_DELTA
 };
 /** Sanity check. */
 static_assert(lengthof(_admin_update_type_frequencies) == ADMIN_UPDATE_END);
@@ -121,6 +123,7 @@ ServerNetworkAdminSocketHandler::~ServerNetworkAdminSocketHandler()
 {
 	ServerNetworkAdminSocketHandler *as = new ServerNetworkAdminSocketHandler(s);
 	as->address = address; // Save the IP of the client
+	ServerNetworkAdminSocketHandler::RegisterSocket(as);
 }
 
 /***********
@@ -155,7 +158,7 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendProtocol()
 
 	for (int i = 0; i < ADMIN_UPDATE_END; i++) {
 		p->Send_bool  (true);
-		p->Send_uint16(i);
+		p->Send_uint16(GetAdminUpdateTypeWireValue((AdminUpdateType)i));
 		p->Send_uint16(_admin_update_type_frequencies[i]);
 	}
 
@@ -191,6 +194,9 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendNewGame()
 {
 	Packet *p = new Packet(ADMIN_PACKET_SERVER_NEWGAME);
 	this->SendPacket(p);
+
+	/* The statistics of the old game are meaningless now, so resend everything. */
+	this->stats_delta_baseline = AdminStatsSnapshot();
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
@@ -439,6 +445,179 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCompanyStats()
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/** Mask of the record ID in the key of a statistics record. */
+static const uint64 ADMIN_STATS_RECORD_ID_MASK = (UINT64_C(1) << 56) - 1;
+
+/**
+ * Get the key of a statistics record.
+ * @param type The record type.
+ * @param id The record ID.
+ * @return The key.
+ */
+static inline uint64 GetAdminStatsRecordKey(AdminStatsDeltaRecordType type, uint32 id)
+{
+	return ((uint64)type << 56) | id;
+}
+
+/**
+ * Populate the snapshot with the current statistics.
+ * Each record type has a fixed number of fields, which are documented in docs/admin_network.md.
+ */
+void AdminStatsSnapshot::Populate()
+{
+	this->records.clear();
+	this->fields.clear();
+
+	auto begin_record = [this](AdminStatsDeltaRecordType type, uint32 id) {
+		this->records.push_back({ GetAdminStatsRecordKey(type, id), (uint32)this->fields.size(), 0 });
+	};
+	auto add_field = [this](int64 value) {
+		this->fields.push_back(value);
+		this->records.back().field_count++;
+	};
+
+	NetworkCompanyStats company_stats[MAX_COMPANIES];
+	NetworkPopulateCompanyStats(company_stats);
+
+	for (const Company *company : Company::Iterate()) {
+		Money income = 0;
+		for (uint i = 0; i < lengthof(company->yearly_expenses[0]); i++) {
+			income -= company->yearly_expenses[0][i];
+		}
+
+		begin_record(ADMIN_SDR_COMPANY, company->index);
+		add_field(company->money);
+		add_field(company->current_loan);
+		add_field(income);
+		add_field(company->cur_economy.delivered_cargo.GetSum<OverflowSafeInt64>());
+		add_field(company->old_economy[0].company_value);
+		add_field(company->old_economy[0].performance_history);
+		for (uint i = 0; i < NETWORK_VEH_END; i++) {
+			add_field(company_stats[company->index].num_vehicle[i]);
+		}
+		for (uint i = 0; i < NETWORK_VEH_END; i++) {
+			add_field(company_stats[company->index].num_station[i]);
+		}
+	}
+
+	for (const Station *st : Station::Iterate()) {
+		begin_record(ADMIN_SDR_STATION, st->index);
+		add_field(st->owner);
+		add_field(st->facilities);
+		add_field(TileX(st->xy));
+		add_field(TileY(st->xy));
+	}
+
+	for (const Station *st : Station::Iterate()) {
+		for (CargoID c = 0; c < NUM_CARGO; c++) {
+			const GoodsEntry &ge = st->goods[c];
+			if (!ge.HasRating()) continue;
+
+			begin_record(ADMIN_SDR_STATION_CARGO, (st->index << 8) | c);
+			add_field(ge.cargo.TotalCount());
+			add_field(ge.rating);
+			add_field(ge.flows.GetFlow());
+		}
+	}
+}
+
+/**
+ * Append an unsigned integer to a buffer, in the variable length encoding of the statistics deltas.
+ * Each byte holds 7 bits, least significant first, the top bit is set when more bytes follow.
+ * @param buffer The buffer.
+ * @param value The value.
+ */
+static void AdminStatsAppendVarUint(std::vector<byte> &buffer, uint64 value)
+{
+	while (value >= 0x80) {
+		buffer.push_back((byte)(value | 0x80));
+		value >>= 7;
+	}
+	buffer.push_back((byte)value);
+}
+
+/**
+ * Append a signed integer to a buffer, in the variable length encoding of the statistics deltas.
+ * The value is zigzag encoded (0, -1, 1, -2, ... become 0, 1, 2, 3, ...), so small negative values stay short.
+ * @param buffer The buffer.
+ * @param value The value.
+ */
+static void AdminStatsAppendVarInt(std::vector<byte> &buffer, int64 value)
+{
+	AdminStatsAppendVarUint(buffer, ((uint64)value << 1) ^ (uint64)(value >> 63));
+}
+
+/**
+ * Send the changes of the statistics since the previous update to the admin.
+ * Only changed records and fields are sent, the first update after connecting or a new game contains everything.
+ * @param snapshot The current statistics.
+ */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendStatsDelta(const AdminStatsSnapshot &snapshot)
+{
+	const AdminStatsSnapshot &baseline = this->stats_delta_baseline;
+
+	Packet *p = nullptr;
+	size_t flags_pos = 0;
+	AdminStatsDeltaFlags flags = baseline.records.empty() ? ADMIN_SDF_RESET : (AdminStatsDeltaFlags)0;
+	auto new_packet = [&]() {
+		p = new Packet(ADMIN_PACKET_SERVER_STATS_DELTA);
+		flags_pos = p->Size();
+		p->Send_uint8(flags);
+		p->Send_uint32(_date);
+	};
+	new_packet();
+
+	std::vector<byte> record;
+	size_t old_index = 0;
+	size_t new_index = 0;
+	while (old_index < baseline.records.size() || new_index < snapshot.records.size()) {
+		const AdminStatsSnapshot::Record *old_record = old_index < baseline.records.size() ? &baseline.records[old_index] : nullptr;
+		const AdminStatsSnapshot::Record *new_record = new_index < snapshot.records.size() ? &snapshot.records[new_index] : nullptr;
+
+		record.clear();
+		if (new_record == nullptr || (old_record != nullptr && old_record->key < new_record->key)) {
+			/* The record does not exist anymore. */
+			record.push_back((byte)((old_record->key >> 56) | ADMIN_SDR_REMOVED));
+			AdminStatsAppendVarUint(record, old_record->key & ADMIN_STATS_RECORD_ID_MASK);
+			old_index++;
+		} else {
+			const bool is_new = (old_record == nullptr || old_record->key != new_record->key);
+			if (!is_new) {
+				assert(old_record->field_count == new_record->field_count);
+				old_index++;
+			}
+			new_index++;
+
+			uint64 mask = 0;
+			for (uint i = 0; i < new_record->field_count; i++) {
+				if (is_new || baseline.fields[old_record->first_field + i] != snapshot.fields[new_record->first_field + i]) SetBit(mask, i);
+			}
+			if (mask == 0) continue;
+
+			record.push_back((byte)(new_record->key >> 56));
+			AdminStatsAppendVarUint(record, new_record->key & ADMIN_STATS_RECORD_ID_MASK);
+			AdminStatsAppendVarUint(record, mask);
+			for (uint i = 0; i < new_record->field_count; i++) {
+				if (HasBit(mask, i)) AdminStatsAppendVarInt(record, snapshot.fields[new_record->first_field + i]);
+			}
+		}
+
+		if (!p->CanWriteToPacket(record.size())) {
+			this->SendPacket(p);
+			flags &= ~ADMIN_SDF_RESET;
+			new_packet();
+		}
+		p->Send_binary(record.data(), record.size());
+	}
+
+	p->WriteAtOffset_uint8(flags_pos, flags | ADMIN_SDF_LAST);
+	this->SendPacket(p);
+
+	this->stats_delta_baseline = snapshot;
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /**
  * Send a chat message.
  * @param action The action associated with the message.
@@ -611,11 +790,12 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCmdNames()
 }
 
 /**
- * Send a command for logging purposes.
+ * Create a packet with a command for logging purposes, this can be sent to any number of admins.
  * @param client_id The client executing the command.
  * @param cp The command that would be executed.
+ * @return The packet.
  */
-NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCmdLogging(ClientID client_id, const CommandPacket *cp)
+/* static */ Packet *ServerNetworkAdminSocketHandler::NewCmdLoggingPacket(ClientID client_id, const CommandPacket *cp)
 {
 	Packet *p = new Packet(ADMIN_PACKET_SERVER_CMD_LOGGING);
 
@@ -634,9 +814,7 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCmdLogging(ClientID clien
 
 	p->Send_uint32(cp->frame);
 
-	this->SendPacket(p);
-
-	return NETWORK_RECV_STATUS_OKAY;
+	return p;
 }
 
 /***********
@@ -680,7 +858,7 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_UPDATE_FREQUENC
 {
 	if (this->status == ADMIN_STATUS_INACTIVE) return this->SendError(NETWORK_ERROR_NOT_EXPECTED);
 
-	AdminUpdateType type = (AdminUpdateType)p->Recv_uint16();
+	AdminUpdateType type = GetAdminUpdateTypeFromWireValue(p->Recv_uint16());
 	AdminUpdateFrequency freq = (AdminUpdateFrequency)p->Recv_uint16();
 
 	if (type >= ADMIN_UPDATE_END || (_admin_update_type_frequencies[type] & freq) != freq) {
@@ -700,7 +878,7 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_POLL(Packet *p)
 {
 	if (this->status == ADMIN_STATUS_INACTIVE) return this->SendError(NETWORK_ERROR_NOT_EXPECTED);
 
-	AdminUpdateType type = (AdminUpdateType)p->Recv_uint8();
+	AdminUpdateType type = GetAdminUpdateTypeFromWireValue(p->Recv_uint8());
 	uint32 d1 = p->Recv_uint32();
 
 	switch (type) {
@@ -753,6 +931,15 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_POLL(Packet *p)
 			this->SendCmdNames();
 			break;
 
+		case ADMIN_UPDATE_STATS_DELTA: {
+			/* The admin is requesting the statistics changes, or all statistics if d1 is not 0. */
+			if (d1 != 0) this->stats_delta_baseline = AdminStatsSnapshot();
+			AdminStatsSnapshot snapshot;
+			snapshot.Populate();
+			this->SendStatsDelta(snapshot);
+			break;
+		}
+
 		default:
 			/* An unsupported "poll" update type. */
 			DEBUG(net, 1, "[admin] Not supported poll %d (%d) from '%s' (%s).", type, d1, this->admin_name.c_str(), this->admin_version.c_str());
@@ -980,9 +1167,12 @@ void NetworkAdminCmdLogging(const NetworkClientSocket *owner, const CommandPacke
 {
 	ClientID client_id = owner == nullptr ? _network_own_client_id : owner->client_id;
 
+	/* The packet is the same for all admins, so it is only created once. */
+	std::shared_ptr<const Packet> packet;
 	for (ServerNetworkAdminSocketHandler *as : ServerNetworkAdminSocketHandler::IterateActive()) {
 		if (as->update_frequency[ADMIN_UPDATE_CMD_LOGGING] & ADMIN_FREQUENCY_AUTOMATIC) {
-			as->SendCmdLogging(client_id, cp);
+			if (packet == nullptr) packet = PrepareSharedPacket(ServerNetworkAdminSocketHandler::NewCmdLoggingPacket(client_id, cp));
+			as->SendSharedPacket(packet);
 		}
 	}
 }
@@ -1003,6 +1193,9 @@ void ServerNetworkAdminSocketHandler::WelcomeAll()
  */
 void NetworkAdminUpdate(AdminUpdateFrequency freq)
 {
+	/* The statistics are only collected once, for all admins which want them. */
+	std::unique_ptr<AdminStatsSnapshot> stats_snapshot;
+
 	for (ServerNetworkAdminSocketHandler *as : ServerNetworkAdminSocketHandler::IterateActive()) {
 		for (int i = 0; i < ADMIN_UPDATE_END; i++) {
 			if (as->update_frequency[i] & freq) {
@@ -1020,6 +1213,14 @@ void NetworkAdminUpdate(AdminUpdateFrequency freq)
 						as->SendCompanyStats();
 						break;
 
+					case ADMIN_UPDATE_STATS_DELTA:
+						if (stats_snapshot == nullptr) {
+							stats_snapshot.reset(new AdminStatsSnapshot());
+							stats_snapshot->Populate();
+						}
+						as->SendStatsDelta(*stats_snapshot);
+						break;
+
 					default: NOT_REACHED();
 				}
 			}
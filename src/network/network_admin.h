@@ -16,6 +16,24 @@
 
 extern AdminIndex _redirect_console_to_admin;
 
+/**
+ * Values of the company and station statistics records, which are sent as deltas to the admins.
+ * The records are sorted by key, so two snapshots can be compared in a single pass.
+ */
+struct AdminStatsSnapshot {
+	/** A record, its fields are stored in AdminStatsSnapshot::fields. */
+	struct Record {
+		uint64 key;         ///< Record type in the top byte, followed by the record ID.
+		uint32 first_field; ///< Index of the first field in AdminStatsSnapshot::fields.
+		uint8 field_count;  ///< Number of fields.
+	};
+
+	std::vector<Record> records; ///< The records, sorted by key.
+	std::vector<int64> fields;   ///< The fields of all records.
+
+	void Populate();
+};
+
 class ServerNetworkAdminSocketHandler;
 /** Pool with all admin connections. */
 typedef Pool<ServerNetworkAdminSocketHandler, AdminIndex, 2, MAX_ADMINS, PT_NADMIN> NetworkAdminSocketPool;
@@ -40,6 +58,7 @@ public:
 	AdminUpdateFrequency update_frequency[ADMIN_UPDATE_END]; ///< Admin requested update intervals.
 	std::chrono::steady_clock::time_point connect_time;      ///< Time of connection.
 	NetworkAddress address;                                  ///< Address of the admin.
+	AdminStatsSnapshot stats_delta_baseline;                 ///< Statistics as last sent for #ADMIN_UPDATE_STATS_DELTA.
 
 	ServerNetworkAdminSocketHandler(SOCKET s);
 	~ServerNetworkAdminSocketHandler();
@@ -61,13 +80,14 @@ public:
 	NetworkRecvStatus SendCompanyRemove(CompanyID company_id, AdminCompanyRemoveReason bcrr);
 	NetworkRecvStatus SendCompanyEconomy();
 	NetworkRecvStatus SendCompanyStats();
+	NetworkRecvStatus SendStatsDelta(const AdminStatsSnapshot &snapshot);
 
 	NetworkRecvStatus SendChat(NetworkAction action, DestType desttype, ClientID client_id, const std::string &msg, NetworkTextMessageData data);
 	NetworkRecvStatus SendRcon(uint16 colour, const std::string_view command);
 	NetworkRecvStatus SendConsole(const std::string_view origin, const std::string_view command);
 	NetworkRecvStatus SendGameScript(const std::string_view json);
 	NetworkRecvStatus SendCmdNames();
-	NetworkRecvStatus SendCmdLogging(ClientID client_id, const CommandPacket *cp);
+	static Packet *NewCmdLoggingPacket(ClientID client_id, const CommandPacket *cp);
 	NetworkRecvStatus SendRconEnd(const std::string_view command);
 
 	static void Send();
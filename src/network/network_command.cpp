@@ -133,6 +133,10 @@ void CommandQueue::Free()
 static CommandQueue _local_wait_queue;
 /** Local queue of packets waiting for execution. */
 static CommandQueue _local_execution_queue;
+/** Local queues of packets of each company, which are deferred while AI scripts run in parallel. */
+static CommandQueue _local_deferred_queues[MAX_COMPANIES];
+/** Whether local packets are deferred, see NetworkServerDeferLocalCommands. */
+static bool _local_commands_deferred = false;
 
 /**
  * Prepare a DoCommand to be send over the network
@@ -176,6 +180,12 @@ void NetworkSendCommand(TileIndex tile, uint32 p1, uint32 p2, uint64 p3, uint32
 		c.frame = _frame_counter_max + 1;
 		c.my_cmd = true;
 
+		if (_local_commands_deferred) {
+			assert(company < MAX_COMPANIES);
+			_local_deferred_queues[company].Append(std::move(c));
+			return;
+		}
+
 		_local_wait_queue.Append(std::move(c));
 		return;
 	}
@@ -186,6 +196,33 @@ void NetworkSendCommand(TileIndex tile, uint32 p1, uint32 p2, uint64 p3, uint32
 	MyClient::SendCommand(&c);
 }
 
+/**
+ * Defer the commands sent by the server itself, until NetworkServerQueueDeferredLocalCommands is called.
+ * This is used while AI scripts run in parallel, so that their commands are queued in the same
+ * order as when they run one after another.
+ */
+void NetworkServerDeferLocalCommands()
+{
+	assert(_network_server && !_local_commands_deferred);
+	_local_commands_deferred = true;
+}
+
+/**
+ * Stop deferring the commands sent by the server itself, and queue the deferred commands in company order.
+ */
+void NetworkServerQueueDeferredLocalCommands()
+{
+	assert(_local_commands_deferred);
+	_local_commands_deferred = false;
+
+	for (CommandQueue &queue : _local_deferred_queues) {
+		std::unique_ptr<CommandPacket> cp;
+		while ((cp = queue.Pop()) != nullptr) {
+			_local_wait_queue.Append(std::move(*cp));
+		}
+	}
+}
+
 /**
  * Sync our local command queue to the command queue of the given
  * socket. This is needed for the case where we receive a command
@@ -196,11 +233,20 @@ void NetworkSendCommand(TileIndex tile, uint32 p1, uint32 p2, uint64 p3, uint32
  * @param cs The client to sync the queue to.
  */
 void NetworkSyncCommandQueue(NetworkClientSocket *cs)
+{
+	NetworkSyncCommandQueue(cs->outgoing_queue);
+}
+
+/**
+ * Copy the local command queue to the given queue, without callbacks.
+ * @param queue The queue to append the commands to.
+ */
+void NetworkSyncCommandQueue(CommandQueue &queue)
 {
 	for (CommandPacket *p = _local_execution_queue.Peek(); p != nullptr; p = p->next) {
 		CommandPacket c = *p;
 		c.callback = nullptr;
-		cs->outgoing_queue.Append(std::move(c));
+		queue.Append(std::move(c));
 	}
 }
 
@@ -247,6 +293,9 @@ void NetworkFreeLocalCommandQueue()
 {
 	_local_wait_queue.Free();
 	_local_execution_queue.Free();
+	for (CommandQueue &queue : _local_deferred_queues) {
+		queue.Free();
+	}
 }
 
 /**
@@ -259,16 +308,32 @@ static void DistributeCommandPacket(CommandPacket &cp, const NetworkClientSocket
 	CommandCallback *callback = cp.callback;
 	cp.frame = _frame_counter_max + 1;
 
+	cp.callback = nullptr;
+	cp.my_cmd = false;
+
 	for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
 		if (cs->status >= NetworkClientSocket::STATUS_MAP) {
+			if (cs != owner) {
+				/* The command packet is the same for all clients except the owner, so it is only created once. */
+				if (cp.shared_packet == nullptr) cp.shared_packet = PrepareSharedPacket(ServerNetworkGameSocketHandler::NewCommandPacket(&cp));
+				cs->outgoing_queue.Append(cp);
+				continue;
+			}
+
 			/* Callbacks are only send back to the client who sent them in the
 			 *  first place. This filters that out. */
-			cp.callback = (cs != owner) ? nullptr : callback;
-			cp.my_cmd = (cs == owner);
-			cs->outgoing_queue.Append(cp);
+			CommandPacket owner_cp = cp;
+			owner_cp.callback = callback;
+			owner_cp.my_cmd = true;
+			owner_cp.shared_packet.reset();
+			cs->outgoing_queue.Append(std::move(owner_cp));
 		}
 	}
 
+	/* Clients which are sent a shared map snapshot later on also need this command. */
+	NetworkServerRecordMapSnapshotCommand(cp);
+
+	cp.shared_packet.reset();
 	cp.callback = (nullptr != owner) ? nullptr : callback;
 	cp.my_cmd = (nullptr == owner);
 	_local_execution_queue.Append(cp);
@@ -76,7 +76,10 @@ void NetworkServerMonthlyLoop();
 void NetworkServerYearlyLoop();
 void NetworkServerSendConfigUpdate();
 void NetworkServerUpdateGameInfo();
+void NetworkServerDeferLocalCommands();
+void NetworkServerQueueDeferredLocalCommands();
 void NetworkServerShowStatusToConsole();
+void NetworkServerShowJoinStatsToConsole();
 bool NetworkServerStart();
 void NetworkServerNewCompany(const Company *company, NetworkClientInfo *ci);
 bool NetworkServerChangeClientName(ClientID client_id, const std::string &new_name);
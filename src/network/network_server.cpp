@@ -193,6 +193,182 @@ struct PacketWriter : SaveFilter {
 	}
 };
 
+/**
+ * A savegame of the map which is shared by all clients which request the map while it is recent enough.
+ * Clients which start downloading after the savegame was made are also sent the commands which
+ * were distributed since then, so that they can catch up to the current frame.
+ */
+struct NetworkMapSnapshot {
+	const uint32 frame;                           ///< Frame at which the savegame was made.
+	const bool zstd;                              ///< Whether the savegame may use zstd compression.
+	CommandQueue commands;                        ///< Commands to execute after loading the savegame.
+
+	std::mutex mutex;                             ///< Mutex for making threaded saving safe.
+	std::vector<std::shared_ptr<const Packet>> packets; ///< Packets of the savegame, the last one is PACKET_SERVER_MAP_DONE when finished.
+	size_t total_size = 0;                        ///< Total size of the compressed savegame, valid when finished.
+	bool finished = false;                        ///< Whether the saving has finished.
+
+	NetworkMapSnapshot(uint32 frame, bool zstd) : frame(frame), zstd(zstd) {}
+
+	/**
+	 * Whether the saving has finished.
+	 * @return True iff all packets of the savegame are available.
+	 */
+	bool IsFinished()
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		return this->finished;
+	}
+
+	/**
+	 * Queue the next packets of the savegame to a client.
+	 * @param cs The client to queue the packets to.
+	 * @param max_packets Maximum number of packets to queue.
+	 * @return True iff the last packet of the map has been queued.
+	 */
+	bool TransferToNetworkQueue(ServerNetworkGameSocketHandler *cs, size_t max_packets)
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+
+		if (this->finished && !cs->map_snapshot_size_sent) {
+			/* Don't queue the PACKET_SERVER_MAP_SIZE before the corresponding PACKET_SERVER_MAP_BEGIN */
+			Packet *p = new Packet(PACKET_SERVER_MAP_SIZE, SHRT_MAX);
+			p->Send_uint32((uint32)this->total_size);
+			cs->SendPrependPacket(std::unique_ptr<Packet>(p), PACKET_SERVER_MAP_BEGIN);
+			cs->map_snapshot_size_sent = true;
+		}
+
+		const size_t end = std::min(this->packets.size(), cs->map_snapshot_pos + max_packets);
+		for (; cs->map_snapshot_pos < end; cs->map_snapshot_pos++) {
+			cs->SendSharedPacket(this->packets[cs->map_snapshot_pos]);
+		}
+
+		return this->finished && cs->map_snapshot_pos == this->packets.size();
+	}
+};
+
+/** Writing a savegame into a shared map snapshot. */
+struct NetworkMapSnapshotWriter : SaveFilter {
+	std::shared_ptr<NetworkMapSnapshot> snapshot; ///< The snapshot we're writing to.
+	std::unique_ptr<Packet> current;              ///< The packet we're currently writing to.
+	size_t total_size = 0;                        ///< Total size of the compressed savegame.
+
+	NetworkMapSnapshotWriter(std::shared_ptr<NetworkMapSnapshot> snapshot) : SaveFilter(nullptr), snapshot(std::move(snapshot)) {}
+
+	/** Append the current packet to the snapshot. */
+	void AppendQueue()
+	{
+		if (this->current == nullptr) return;
+
+		std::shared_ptr<const Packet> packet = PrepareSharedPacket(this->current.release());
+		std::lock_guard<std::mutex> lock(this->snapshot->mutex);
+		this->snapshot->packets.push_back(std::move(packet));
+	}
+
+	void Write(byte *buf, size_t size) override
+	{
+		if (this->current == nullptr) this->current.reset(new Packet(PACKET_SERVER_MAP_DATA, SHRT_MAX));
+
+		byte *bufe = buf + size;
+		while (buf != bufe) {
+			size_t written = this->current->Send_binary_until_full(buf, bufe);
+			buf += written;
+
+			if (!this->current->CanWriteToPacket(1)) {
+				this->AppendQueue();
+				if (buf != bufe) this->current.reset(new Packet(PACKET_SERVER_MAP_DATA, SHRT_MAX));
+			}
+		}
+
+		this->total_size += size;
+	}
+
+	void Finish() override
+	{
+		/* Make sure the last packet is flushed. */
+		this->AppendQueue();
+
+		/* Add a packet stating that this is the end to the queue. */
+		this->current.reset(new Packet(PACKET_SERVER_MAP_DONE, SHRT_MAX));
+		this->AppendQueue();
+
+		std::lock_guard<std::mutex> lock(this->snapshot->mutex);
+		this->snapshot->total_size = this->total_size;
+		this->snapshot->finished = true;
+	}
+};
+
+/** Statistics about clients downloading the map. */
+struct NetworkJoinStats {
+	uint64 map_requests = 0;    ///< Number of clients which requested the map.
+	uint64 snapshots = 0;       ///< Number of shared map snapshots which were made.
+	uint64 snapshot_reuses = 0; ///< Number of clients which were sent an existing shared map snapshot.
+	uint64 joins = 0;           ///< Number of clients which loaded the map.
+	uint64 total_join_ms = 0;   ///< Total time from requesting the map until having loaded it, in milliseconds.
+	uint64 max_join_ms = 0;     ///< Maximum time from requesting the map until having loaded it, in milliseconds.
+	uint64 last_join_ms = 0;    ///< Time from requesting the map until having loaded it of the last client, in milliseconds.
+};
+
+/** The shared map snapshot which is sent to clients requesting the map, if any. */
+static std::shared_ptr<NetworkMapSnapshot> _network_map_snapshot;
+/** Statistics about clients downloading the map. */
+static NetworkJoinStats _network_join_stats;
+
+/** Maximum number of packets of a shared map snapshot to queue to a client at once. */
+static const size_t MAP_SNAPSHOT_PACKETS_PER_SEND = 32;
+
+/**
+ * Whether a shared map snapshot is too old to be sent to more clients.
+ * A snapshot which is still being saved is never too old.
+ * @param snapshot The snapshot.
+ * @return True iff a new snapshot should be made for clients requesting the map.
+ */
+static bool IsMapSnapshotExpired(NetworkMapSnapshot &snapshot)
+{
+	if (!_settings_client.network.shared_map_download) return true;
+	return _frame_counter - snapshot.frame > _settings_client.network.shared_map_download_max_age && snapshot.IsFinished();
+}
+
+/**
+ * Get the shared map snapshot to send to a client, making a new one if there is no recent enough one.
+ * @param zstd Whether the client supports zstd compression.
+ * @return The snapshot.
+ */
+static std::shared_ptr<NetworkMapSnapshot> GetMapSnapshot(bool zstd)
+{
+	if (_network_map_snapshot != nullptr && (zstd || !_network_map_snapshot->zstd) && !IsMapSnapshotExpired(*_network_map_snapshot)) {
+		_network_join_stats.snapshot_reuses++;
+		return _network_map_snapshot;
+	}
+
+	WaitTillSaved();
+	_network_map_snapshot = std::make_shared<NetworkMapSnapshot>(_frame_counter, zstd);
+	NetworkSyncCommandQueue(_network_map_snapshot->commands);
+	_network_join_stats.snapshots++;
+
+	/* Make a dump of the current game */
+	SaveModeFlags flags = SMF_NET_SERVER;
+	if (zstd) flags |= SMF_ZSTD_OK;
+	if (SaveWithFilter(new NetworkMapSnapshotWriter(_network_map_snapshot), true, flags) != SL_OK) usererror("network savedump failed");
+
+	return _network_map_snapshot;
+}
+
+/**
+ * Record a distributed command for clients which are sent the current shared map snapshot later on.
+ * @param cp The command.
+ */
+void NetworkServerRecordMapSnapshotCommand(CommandPacket &cp)
+{
+	if (_network_map_snapshot != nullptr) _network_map_snapshot->commands.Append(cp);
+}
+
+/** Discard the current shared map snapshot, e.g. when the game is closed. */
+void NetworkServerResetMapSnapshot()
+{
+	_network_map_snapshot.reset();
+}
+
 
 /**
  * Create a new socket for the server side of the game connection.
@@ -328,9 +504,14 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::CloseConnection(NetworkRecvSta
 	/* If we were transfering a map to this client, stop the savegame creation
 	 * process and queue the next client to receive the map. */
 	if (this->status == STATUS_MAP) {
-		/* Ensure the saving of the game is stopped too. */
-		this->savegame->Destroy();
-		this->savegame = nullptr;
+		if (this->map_snapshot != nullptr) {
+			/* The shared snapshot is still used by other clients. */
+			this->map_snapshot.reset();
+		} else {
+			/* Ensure the saving of the game is stopped too. */
+			this->savegame->Destroy();
+			this->savegame = nullptr;
+		}
 
 		this->CheckNextClientToSendMap(this);
 	}
@@ -641,6 +822,10 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendMap()
 		return this->SendError(NETWORK_ERROR_NOT_AUTHORIZED);
 	}
 
+	if (this->map_snapshot != nullptr || (this->status == STATUS_AUTHORIZED && _settings_client.network.shared_map_download)) {
+		return this->SendMapFromSnapshot();
+	}
+
 	if (this->status == STATUS_AUTHORIZED) {
 		WaitTillSaved();
 		this->savegame = new PacketWriter(this);
@@ -679,6 +864,50 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendMap()
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/**
+ * Send the map to the client from a shared map snapshot.
+ * Any number of clients can download the same snapshot at the same time, so clients do not have to wait for each other.
+ */
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendMapFromSnapshot()
+{
+	if (this->status == STATUS_AUTHORIZED) {
+		this->map_snapshot = GetMapSnapshot(this->supports_zstd);
+		this->map_snapshot_pos = 0;
+		this->map_snapshot_size_sent = false;
+
+		/* Now send the frame of the snapshot, the client catches up from there */
+		Packet *p = new Packet(PACKET_SERVER_MAP_BEGIN, SHRT_MAX);
+		p->Send_uint32(this->map_snapshot->frame);
+		this->SendPacket(p);
+
+		/* Queue the commands since the snapshot, further commands are queued as they are distributed */
+		for (CommandPacket *cp = this->map_snapshot->commands.Peek(); cp != nullptr; cp = cp->next) {
+			this->outgoing_queue.Append(*cp);
+		}
+		this->status = STATUS_MAP;
+		/* Mark the start of download */
+		this->last_frame = _frame_counter;
+		this->last_frame_server = _frame_counter;
+	}
+
+	if (this->status == STATUS_MAP) {
+		/* Only queue more of the map when the previous part has been sent, to limit the memory used per client. */
+		if (this->HasSendQueue()) return NETWORK_RECV_STATUS_OKAY;
+
+		bool last_packet = this->map_snapshot->TransferToNetworkQueue(this, MAP_SNAPSHOT_PACKETS_PER_SEND);
+		if (last_packet) {
+			this->map_snapshot.reset();
+
+			/* Set the status to DONE_MAP, no we will wait for the client
+			 *  to send it is ready (maybe that happens like never ;)) */
+			this->status = STATUS_DONE_MAP;
+
+			this->CheckNextClientToSendMap();
+		}
+	}
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /**
  * Tell that a client joined.
  * @param client_id The client that joined.
@@ -693,8 +922,11 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendJoin(ClientID client_id)
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
-/** Tell the client that they may run to a particular frame. */
-NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame()
+/**
+ * Create a frame packet, without token.
+ * @return The packet.
+ */
+static Packet *NewFramePacket()
 {
 	Packet *p = new Packet(PACKET_SERVER_FRAME, SHRT_MAX);
 	p->Send_uint32(_frame_counter);
@@ -706,6 +938,22 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame()
 #endif
 	p->Send_uint64(_sync_state_checksum);
 #endif
+	return p;
+}
+
+/**
+ * Tell the client that they may run to a particular frame.
+ * @param shared_packet If not nullptr, the frame packet which is shared by all clients which are not sent a new token this frame, this is created when needed.
+ */
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame(std::shared_ptr<const Packet> *shared_packet)
+{
+	if (shared_packet != nullptr && this->last_token != 0) {
+		if (*shared_packet == nullptr) *shared_packet = PrepareSharedPacket(NewFramePacket());
+		this->SendSharedPacket(*shared_packet);
+		return NETWORK_RECV_STATUS_OKAY;
+	}
+
+	Packet *p = NewFramePacket();
 
 	/* If token equals 0, we need to make a new token and send that. */
 	if (this->last_token == 0) {
@@ -717,9 +965,17 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame()
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
-/** Request the client to sync. */
-NetworkRecvStatus ServerNetworkGameSocketHandler::SendSync()
+/**
+ * Request the client to sync.
+ * @param shared_packet If not nullptr, the sync packet which is shared by all clients this frame, this is created when needed.
+ */
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendSync(std::shared_ptr<const Packet> *shared_packet)
 {
+	if (shared_packet != nullptr && *shared_packet != nullptr) {
+		this->SendSharedPacket(*shared_packet);
+		return NETWORK_RECV_STATUS_OKAY;
+	}
+
 	Packet *p = new Packet(PACKET_SERVER_SYNC, SHRT_MAX);
 	p->Send_uint32(_frame_counter);
 	p->Send_uint32(_sync_seed_1);
@@ -728,7 +984,13 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendSync()
 	p->Send_uint32(_sync_seed_2);
 #endif
 	p->Send_uint64(_sync_state_checksum);
-	this->SendPacket(p);
+
+	if (shared_packet != nullptr) {
+		*shared_packet = PrepareSharedPacket(p);
+		this->SendSharedPacket(*shared_packet);
+	} else {
+		this->SendPacket(p);
+	}
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
@@ -737,15 +999,30 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendSync()
  * @param cp The command to send.
  */
 NetworkRecvStatus ServerNetworkGameSocketHandler::SendCommand(const CommandPacket *cp)
+{
+	if (cp->shared_packet != nullptr) {
+		this->SendSharedPacket(cp->shared_packet);
+		return NETWORK_RECV_STATUS_OKAY;
+	}
+
+	this->SendPacket(NewCommandPacket(cp));
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
+/**
+ * Create a packet with a command for clients to execute.
+ * @param cp The command.
+ * @return The packet.
+ */
+/* static */ Packet *ServerNetworkGameSocketHandler::NewCommandPacket(const CommandPacket *cp)
 {
 	Packet *p = new Packet(PACKET_SERVER_COMMAND, SHRT_MAX);
 
-	this->NetworkGameSocketHandler::SendCommand(p, cp);
+	NetworkGameSocketHandler::SendCommand(p, cp);
 	p->Send_uint32(cp->frame);
 	p->Send_bool  (cp->my_cmd);
 
-	this->SendPacket(p);
-	return NETWORK_RECV_STATUS_OKAY;
+	return p;
 }
 
 /**
@@ -1127,6 +1404,11 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_GETMAP(Packet *
 	}
 
 	this->supports_zstd = p->Recv_bool();
+	this->map_request_time = std::chrono::steady_clock::now();
+	_network_join_stats.map_requests++;
+
+	/* Clients downloading a shared snapshot do not need to wait for each other */
+	if (_settings_client.network.shared_map_download) return this->SendMap();
 
 	/* Check if someone else is receiving the map */
 	for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
@@ -1154,6 +1436,12 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_MAP_OK(Packet *
 
 		DEBUG(net, 3, "[%s] Client #%u (%s) joined as %s", ServerNetworkGameSocketHandler::GetName(), this->client_id, this->GetClientIP(), client_name);
 
+		const uint64 join_ms = (uint64)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - this->map_request_time).count();
+		_network_join_stats.joins++;
+		_network_join_stats.total_join_ms += join_ms;
+		_network_join_stats.max_join_ms = std::max(_network_join_stats.max_join_ms, join_ms);
+		_network_join_stats.last_join_ms = join_ms;
+
 		/* Mark the client as pre-active, and wait for an ACK
 		 *  so we know it is done loading and in sync with us */
 		this->status = STATUS_PRE_ACTIVE;
@@ -2000,6 +2288,9 @@ void NetworkServer_Tick(bool send_frame)
 	bool send_sync = false;
 #endif
 
+	/* Stop recording commands for a shared map snapshot which will not be sent to more clients */
+	if (_network_map_snapshot != nullptr && IsMapSnapshotExpired(*_network_map_snapshot)) _network_map_snapshot.reset();
+
 #ifndef ENABLE_NETWORK_SYNC_EVERY_FRAME
 	if (_frame_counter >= _last_sync_frame + _settings_client.network.sync_freq) {
 		_last_sync_frame = _frame_counter;
@@ -2007,6 +2298,10 @@ void NetworkServer_Tick(bool send_frame)
 	}
 #endif
 
+	/* The frame and sync packets are the same for (almost) all clients, so these are only created once. */
+	std::shared_ptr<const Packet> frame_packet;
+	std::shared_ptr<const Packet> sync_packet;
+
 	/* Now we are done with the frame, inform the clients that they can
 	 *  do their frame! */
 	for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
@@ -2120,11 +2415,11 @@ void NetworkServer_Tick(bool send_frame)
 			NetworkHandleCommandQueue(cs);
 
 			/* Send an updated _frame_counter_max to the client */
-			if (send_frame) cs->SendFrame();
+			if (send_frame) cs->SendFrame(&frame_packet);
 
 #ifndef ENABLE_NETWORK_SYNC_EVERY_FRAME
 			/* Send a sync-check packet */
-			if (send_sync) cs->SendSync();
+			if (send_sync) cs->SendSync(&sync_packet);
 #endif
 		}
 	}
@@ -2193,6 +2488,28 @@ void NetworkServerShowStatusToConsole()
 	}
 }
 
+/**
+ * Print statistics about clients downloading the map to the console.
+ */
+void NetworkServerShowJoinStatsToConsole()
+{
+	const NetworkJoinStats &stats = _network_join_stats;
+	IConsolePrintF(CC_INFO, "Map requests: " OTTD_PRINTF64U ", joins: " OTTD_PRINTF64U, stats.map_requests, stats.joins);
+	IConsolePrintF(CC_INFO, "Shared map snapshots: " OTTD_PRINTF64U ", reused: " OTTD_PRINTF64U " times", stats.snapshots, stats.snapshot_reuses);
+	IConsolePrintF(CC_INFO, "Time from map request to loaded map: last: " OTTD_PRINTF64U " ms, mean: " OTTD_PRINTF64U " ms, max: " OTTD_PRINTF64U " ms",
+			stats.last_join_ms, stats.joins > 0 ? stats.total_join_ms / stats.joins : 0, stats.max_join_ms);
+
+	if (_network_map_snapshot != nullptr) {
+		uint clients = 0;
+		for (const NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
+			if (cs->map_snapshot == _network_map_snapshot) clients++;
+		}
+		IConsolePrintF(CC_INFO, "Current shared map snapshot: frame: %u, age: %u ticks, downloading clients: %u, recorded commands: %u%s",
+				_network_map_snapshot->frame, _frame_counter - _network_map_snapshot->frame, clients, _network_map_snapshot->commands.Count(),
+				_network_map_snapshot->IsFinished() ? "" : ", saving");
+	}
+}
+
 /**
  * Send Config Update
  */
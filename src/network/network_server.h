@@ -13,6 +13,9 @@
 #include "network_internal.h"
 #include "core/tcp_listen.h"
 
+#include <chrono>
+#include <memory>
+
 class ServerNetworkGameSocketHandler;
 /** Make the code look slightly nicer/simpler. */
 typedef ServerNetworkGameSocketHandler NetworkClientSocket;
@@ -86,6 +89,10 @@ public:
 	bool supports_zstd = false;  ///< Client supports zstd compression
 
 	struct PacketWriter *savegame; ///< Writer used to write the savegame.
+	std::shared_ptr<struct NetworkMapSnapshot> map_snapshot; ///< Shared savegame which is being sent to this client, if any.
+	size_t map_snapshot_pos = 0;                              ///< Number of packets of map_snapshot which have been queued.
+	bool map_snapshot_size_sent = false;                      ///< Whether the map size packet for map_snapshot has been queued.
+	std::chrono::steady_clock::time_point map_request_time;   ///< Time at which the client requested the map.
 	NetworkAddress client_address; ///< IP-address of the client (so they can be banned)
 
 	std::string desync_log;
@@ -107,6 +114,7 @@ public:
 
 	NetworkRecvStatus SendWait();
 	NetworkRecvStatus SendMap();
+	NetworkRecvStatus SendMapFromSnapshot();
 	NetworkRecvStatus SendErrorQuit(ClientID client_id, NetworkErrorCode errorno);
 	NetworkRecvStatus SendQuit(ClientID client_id);
 	NetworkRecvStatus SendShutdown();
@@ -121,9 +129,10 @@ public:
 	NetworkRecvStatus SendChat(NetworkAction action, ClientID client_id, bool self_send, const std::string &msg, NetworkTextMessageData data);
 	NetworkRecvStatus SendExternalChat(const std::string &source, TextColour colour, const std::string &user, const std::string &msg);
 	NetworkRecvStatus SendJoin(ClientID client_id);
-	NetworkRecvStatus SendFrame();
-	NetworkRecvStatus SendSync();
+	NetworkRecvStatus SendFrame(std::shared_ptr<const Packet> *shared_packet = nullptr);
+	NetworkRecvStatus SendSync(std::shared_ptr<const Packet> *shared_packet = nullptr);
 	NetworkRecvStatus SendCommand(const CommandPacket *cp);
+	static Packet *NewCommandPacket(const CommandPacket *cp);
 	NetworkRecvStatus SendCompanyUpdate();
 	NetworkRecvStatus SendConfigUpdate();
 	NetworkRecvStatus SendSettingsAccessUpdate(bool ok);
@@ -159,5 +168,7 @@ public:
 void NetworkServer_Tick(bool send_frame);
 void NetworkServerSetCompanyPassword(CompanyID company_id, const std::string &password, bool already_hashed = true);
 void NetworkServerUpdateCompanyPassworded(CompanyID company_id, bool passworded);
+void NetworkServerRecordMapSnapshotCommand(CommandPacket &cp);
+void NetworkServerResetMapSnapshot();
 
 #endif /* NETWORK_SERVER_H */
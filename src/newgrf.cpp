@@ -11706,6 +11706,9 @@ void LoadNewGRF(uint load_index, uint num_baseset)
 	_cur.ClearDataForNextFile();
 	_callback_result_cache.clear();
 
+	/* All action 2 chains are now final */
+	CompileDeterministicSpriteGroupPrograms();
+
 	/* Call any functions that should be run after GRFs have been loaded. */
 	AfterLoadGRFs();
 
@@ -14,6 +14,33 @@
 
 #include "safeguards.h"
 
+/**
+ * Whether a vehicle variable only depends on state which, when changed, clears the #VehicleCallbackMemo of the vehicle.
+ * @param variable the variable
+ * @return true if the variable is safe for memoised callbacks
+ */
+static bool IsVehicleCallbackMemoVariable(uint16 variable)
+{
+	switch (variable) {
+		case 0x0C: // callback ID, part of the key
+		case 0x10: // callback param 1, part of the key
+		case 0x18: // callback param 2, part of the key
+		case 0x1A: // constant
+		case 0x1C: // last computed value in this resolve
+		case 0x7D: // temporary storage, cleared at the start of each resolve
+		case 0x7E: // procedure call, analysed separately
+		case 0x7F: // GRF parameter
+		case 0x40: // position in consist, cached in the NewGRF cache
+		case 0x41: // position in same ID sequence, cached in the NewGRF cache
+		case 0x42: // consist cargo information, cached in the NewGRF cache
+		case 0x47: // cargo type information, the cargo type is checked by the memo
+			return true;
+
+		default:
+			return false;
+	}
+}
+
 void DeterministicSpriteGroup::AnalyseCallbacks(AnalyseCallbackOperation &op) const
 {
 	auto res = op.seen.insert(this);
@@ -22,6 +49,28 @@ void DeterministicSpriteGroup::AnalyseCallbacks(AnalyseCallbackOperation &op) co
 		return;
 	}
 
+	if (op.mode == ACOM_CB_MEMOISE) {
+		if (op.result_flags & ACORF_CB_MEMOISE_NON_WHITELIST_FOUND) return;
+		if (this->var_scope != VSG_SCOPE_SELF) {
+			op.result_flags |= ACORF_CB_MEMOISE_NON_WHITELIST_FOUND;
+			return;
+		}
+		for (const auto &adjust : this->adjusts) {
+			if (!IsVehicleCallbackMemoVariable(adjust.variable) || adjust.operation == DSGA_OP_STOP) {
+				op.result_flags |= ACORF_CB_MEMOISE_NON_WHITELIST_FOUND;
+				return;
+			}
+			if (adjust.variable == 0x7E && adjust.subroutine != nullptr) adjust.subroutine->AnalyseCallbacks(op);
+		}
+		if (!this->calculated_result) {
+			for (const auto &range : this->ranges) {
+				if (range.group != nullptr) range.group->AnalyseCallbacks(op);
+			}
+			if (this->default_group != nullptr) this->default_group->AnalyseCallbacks(op);
+		}
+		return;
+	}
+
 	if (op.mode == ACOM_INDUSTRY_TILE && op.data.indtile->anim_state_at_offset) return;
 
 	auto check_1A_range = [&]() -> bool {
@@ -299,6 +348,12 @@ void RandomizedSpriteGroup::AnalyseCallbacks(AnalyseCallbackOperation &op) const
 {
 	op.result_flags |= ACORF_CB_REFIT_CAP_NON_WHITELIST_FOUND;
 
+	if (op.mode == ACOM_CB_MEMOISE) {
+		/* The result depends on the random bits */
+		op.result_flags |= ACORF_CB_MEMOISE_NON_WHITELIST_FOUND;
+		return;
+	}
+
 	if ((op.mode == ACOM_CB_VAR || op.mode == ACOM_FIND_RANDOM_TRIGGER) && (this->triggers != 0 || this->cmp_mode == RSG_CMP_ALL)) {
 		op.callbacks_used |= SGCU_RANDOM_TRIGGER;
 	}
@@ -307,3 +362,11 @@ void RandomizedSpriteGroup::AnalyseCallbacks(AnalyseCallbackOperation &op) const
 		if (group != nullptr) group->AnalyseCallbacks(op);
 	}
 }
+
+void RealSpriteGroup::AnalyseCallbacks(AnalyseCallbackOperation &op) const
+{
+	if (op.mode == ACOM_CB_MEMOISE) {
+		/* The result depends on the loading state of the vehicle */
+		op.result_flags |= ACORF_CB_MEMOISE_NON_WHITELIST_FOUND;
+	}
+}
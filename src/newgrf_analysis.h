@@ -24,6 +24,7 @@ enum AnalyseCallbackOperationMode : uint8 {
 	ACOM_INDUSTRY_TILE,
 	ACOM_CB_REFIT_CAPACITY,
 	ACOM_FIND_RANDOM_TRIGGER,
+	ACOM_CB_MEMOISE,
 };
 
 struct AnalyseCallbackOperationIndustryTileData;
@@ -33,6 +34,7 @@ enum AnalyseCallbackOperationResultFlags : uint8 {
 	ACORF_CB_RESULT_FOUND                   = 1 << 0,
 	ACORF_CB_REFIT_CAP_NON_WHITELIST_FOUND  = 1 << 1,
 	ACORF_CB_REFIT_CAP_SEEN_VAR_47          = 1 << 2,
+	ACORF_CB_MEMOISE_NON_WHITELIST_FOUND    = 1 << 3,
 };
 DECLARE_ENUM_AS_BIT_SET(AnalyseCallbackOperationResultFlags)
 
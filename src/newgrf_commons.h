@@ -340,6 +340,7 @@ enum SpriteGroupCallbacksUsed : uint8 {
 	SGCU_RANDOM_TRIGGER                 = 1 << 2,
 	SGCU_CB36_SPEED_RAILTYPE            = 1 << 3,
 	SGCU_REFIT_CB_ALL_CARGOES           = 1 << 4,
+	SGCU_CB_RESULT_MEMOISABLE           = 1 << 5, ///< Callback results only depend on state which invalidates the #VehicleCallbackMemo
 };
 DECLARE_ENUM_AS_BIT_SET(SpriteGroupCallbacksUsed)
 
@@ -28,6 +28,7 @@
 #include "scope_info.h"
 #include "newgrf_extension.h"
 #include "newgrf_analysis.h"
+#include "debug_settings.h"
 
 #include "safeguards.h"
 
@@ -1311,6 +1312,86 @@ bool UsesWagonOverride(const Vehicle *v)
 	return Train::From(v)->tcache.cached_override != nullptr;
 }
 
+VehicleCallbackMemoStats _vehicle_callback_memo_stats;
+
+/**
+ * Whether the result of a callback of the given vehicle may be memoised in its #VehicleCallbackMemo.
+ * The callbacks are limited to those where the caller does not read any registers set by the callback.
+ * @param callback The callback
+ * @param engine   Engine type to evaluate the callback for
+ * @param v        The vehicle
+ * @return true if the result may be memoised
+ */
+static bool IsVehicleCallbackMemoisable(CallbackID callback, EngineID engine, const Vehicle *v)
+{
+	switch (callback) {
+		case CBID_VEHICLE_VISUAL_EFFECT:
+		case CBID_VEHICLE_LENGTH:
+		case CBID_VEHICLE_LOAD_AMOUNT:
+		case CBID_VEHICLE_REFIT_CAPACITY:
+		case CBID_VEHICLE_MODIFY_PROPERTY:
+			break;
+
+		default:
+			return false;
+	}
+
+	return v != nullptr && v->engine_type == engine && (Engine::Get(engine)->callbacks_used & SGCU_CB_RESULT_MEMOISABLE) && !HasChickenBit(DCBF_NO_VEHICLE_CALLBACK_MEMO);
+}
+
+/**
+ * Look up a memoised callback result of a vehicle.
+ * Any memoised results of a previous tick or a different cargo type/subtype are discarded.
+ * @param v        The vehicle
+ * @param callback The callback
+ * @param param1   First parameter of the callback
+ * @param param2   Second parameter of the callback
+ * @param[out] result The memoised result, if found
+ * @return true if a memoised result was found
+ */
+static bool LookupVehicleCallbackMemo(const Vehicle *v, CallbackID callback, uint32 param1, uint32 param2, uint16 &result)
+{
+	VehicleCallbackMemo &memo = v->callback_memo;
+	if (memo.tick != _scaled_tick_counter || memo.cargo_type != v->cargo_type || memo.cargo_subtype != v->cargo_subtype) {
+		memo.Clear();
+		memo.tick = _scaled_tick_counter;
+		memo.cargo_type = v->cargo_type;
+		memo.cargo_subtype = v->cargo_subtype;
+	} else {
+		for (uint i = 0; i < memo.count; i++) {
+			const VehicleCallbackMemo::Entry &entry = memo.entries[i];
+			if (entry.callback == callback && entry.param1 == param1 && entry.param2 == param2) {
+				_vehicle_callback_memo_stats.hits++;
+				result = entry.result;
+				return true;
+			}
+		}
+	}
+	_vehicle_callback_memo_stats.misses++;
+	return false;
+}
+
+/**
+ * Memoise a callback result of a vehicle, after a failed LookupVehicleCallbackMemo.
+ * @param v        The vehicle
+ * @param callback The callback
+ * @param param1   First parameter of the callback
+ * @param param2   Second parameter of the callback
+ * @param result   The result of the callback
+ */
+static void StoreVehicleCallbackMemo(const Vehicle *v, CallbackID callback, uint32 param1, uint32 param2, uint16 result)
+{
+	VehicleCallbackMemo &memo = v->callback_memo;
+	uint index;
+	if (memo.count < VehicleCallbackMemo::MAX_ENTRIES) {
+		index = memo.count++;
+	} else {
+		index = memo.next;
+		memo.next = (memo.next + 1) % VehicleCallbackMemo::MAX_ENTRIES;
+	}
+	memo.entries[index] = { param1, param2, (uint16)callback, result };
+}
+
 /**
  * Evaluate a newgrf callback for vehicles
  * @param callback The callback to evaluate
@@ -1322,8 +1403,14 @@ bool UsesWagonOverride(const Vehicle *v)
  */
 uint16 GetVehicleCallback(CallbackID callback, uint32 param1, uint32 param2, EngineID engine, const Vehicle *v)
 {
+	const bool memoisable = IsVehicleCallbackMemoisable(callback, engine, v);
+	uint16 result;
+	if (memoisable && LookupVehicleCallbackMemo(v, callback, param1, param2, result)) return result;
+
 	VehicleResolverObject object(engine, v, VehicleResolverObject::WO_UNCACHED, false, callback, param1, param2);
-	return object.ResolveCallback();
+	result = object.ResolveCallback();
+	if (memoisable) StoreVehicleCallbackMemo(v, callback, param1, param2, result);
+	return result;
 }
 
 /**
@@ -1356,14 +1443,20 @@ int GetEngineProperty(EngineID engine, PropertyID property, int orig_value, cons
 	const Engine *e = Engine::Get(engine);
 	if (static_cast<uint>(property) < 64 && !HasBit(e->cb36_properties_used, property)) return orig_value;
 
-	VehicleResolverObject object(engine, v, VehicleResolverObject::WO_UNCACHED, false, CBID_VEHICLE_MODIFY_PROPERTY, property, 0);
-	if (static_cast<uint>(property) < 64 && !e->sprite_group_cb36_properties_used.empty()) {
-		auto iter = e->sprite_group_cb36_properties_used.find(object.root_spritegroup);
-		if (iter != e->sprite_group_cb36_properties_used.end()) {
-			if (!HasBit(iter->second, property)) return orig_value;
+	const bool memoisable = IsVehicleCallbackMemoisable(CBID_VEHICLE_MODIFY_PROPERTY, engine, v);
+	uint16 callback;
+	if (!memoisable || !LookupVehicleCallbackMemo(v, CBID_VEHICLE_MODIFY_PROPERTY, property, 0, callback)) {
+		VehicleResolverObject object(engine, v, VehicleResolverObject::WO_UNCACHED, false, CBID_VEHICLE_MODIFY_PROPERTY, property, 0);
+		bool property_used = true;
+		if (static_cast<uint>(property) < 64 && !e->sprite_group_cb36_properties_used.empty()) {
+			auto iter = e->sprite_group_cb36_properties_used.find(object.root_spritegroup);
+			if (iter != e->sprite_group_cb36_properties_used.end()) {
+				property_used = HasBit(iter->second, property);
+			}
 		}
+		callback = property_used ? object.ResolveCallback() : CALLBACK_FAILED;
+		if (memoisable) StoreVehicleCallbackMemo(v, CBID_VEHICLE_MODIFY_PROPERTY, property, 0, callback);
 	}
-	uint16 callback = object.ResolveCallback();
 	if (callback != CALLBACK_FAILED) {
 		if (is_signed) {
 			/* Sign extend 15 bit integer */
@@ -1406,6 +1499,7 @@ static void DoTriggerVehicle(Vehicle *v, VehicleTrigger trigger, uint16 base_ran
 	byte new_random_bits = Random();
 	v->random_bits &= ~reseed;
 	v->random_bits |= (first ? new_random_bits : base_random_bits) & reseed;
+	v->callback_memo.Clear();
 
 	switch (trigger) {
 		case VEHICLE_TRIGGER_NEW_CARGO:
@@ -1603,6 +1697,7 @@ void AnalyseEngineCallbacks()
 		uint64 cb36_properties_used = 0;
 		bool refit_cap_whitelist_ok = true;
 		bool refit_cap_no_var_47 = true;
+		bool memoisable = true;
 		uint non_purchase_groups = 0;
 		auto process_sg = [&](const SpriteGroup *sg, bool is_purchase) {
 			if (sg == nullptr) return;
@@ -1615,6 +1710,13 @@ void AnalyseEngineCallbacks()
 			if ((op.result_flags & ACORF_CB_REFIT_CAP_NON_WHITELIST_FOUND) && !is_purchase) refit_cap_whitelist_ok = false;
 			if ((op.result_flags & ACORF_CB_REFIT_CAP_SEEN_VAR_47) && !is_purchase) refit_cap_no_var_47 = false;
 			if (!is_purchase) non_purchase_groups++;
+
+			/* The purchase sprite group is not used for existing vehicles */
+			if (memoisable && !is_purchase) {
+				AnalyseCallbackOperation memo_op(ACOM_CB_MEMOISE);
+				sg->AnalyseCallbacks(memo_op);
+				if (memo_op.result_flags & ACORF_CB_MEMOISE_NON_WHITELIST_FOUND) memoisable = false;
+			}
 		};
 
 		for (uint i = 0; i < NUM_CARGO + 2; i++) {
@@ -1623,6 +1725,7 @@ void AnalyseEngineCallbacks()
 		for (const WagonOverride &wo : e->overrides) {
 			process_sg(wo.group, false);
 		}
+		if (memoisable) callbacks_used |= SGCU_CB_RESULT_MEMOISABLE;
 		e->callbacks_used = callbacks_used;
 		e->cb36_properties_used = cb36_properties_used;
 		for (auto iter : sg_cb36) {
@@ -94,6 +94,13 @@ struct GRFFile;
 
 void SetEngineGRF(EngineID engine, const struct GRFFile *file);
 
+/** Statistics of the memoised vehicle callback results, see #VehicleCallbackMemo. */
+struct VehicleCallbackMemoStats {
+	uint64 hits = 0;
+	uint64 misses = 0;
+};
+extern VehicleCallbackMemoStats _vehicle_callback_memo_stats;
+
 uint16 GetVehicleCallback(CallbackID callback, uint32 param1, uint32 param2, EngineID engine, const Vehicle *v);
 uint16 GetVehicleCallbackParent(CallbackID callback, uint32 param1, uint32 param2, EngineID engine, const Vehicle *v, const Vehicle *parent);
 bool UsesWagonOverride(const Vehicle *v);
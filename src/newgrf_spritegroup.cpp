@@ -171,10 +171,10 @@ static inline uint32 GetVariable(const ResolverObject &object, ScopeResolver *sc
 	return &this->default_scope;
 }
 
-/* Evaluate an adjustment for a variable of the given size.
+/* Apply the shift, mask and type of an adjustment to a variable value, for a variable of the given size.
  * U is the unsigned type and S is the signed type to use. */
 template <typename U, typename S>
-static U EvalAdjustT(const DeterministicSpriteGroupAdjust &adjust, ScopeResolver *scope, U last_value, uint32 value, const DeterministicSpriteGroupAdjust **adjust_iter = nullptr)
+static inline uint32 EvalAdjustValueT(const DeterministicSpriteGroupAdjust &adjust, uint32 value)
 {
 	value >>= adjust.shift_num;
 	value  &= adjust.and_mask;
@@ -187,6 +187,15 @@ static U EvalAdjustT(const DeterministicSpriteGroupAdjust &adjust, ScopeResolver
 		case DSGA_TYPE_NONE: break;
 	}
 
+	return value;
+}
+
+/* Apply the operation of an adjustment to the accumulator, for a variable of the given size.
+ * U is the unsigned type and S is the signed type to use.
+ * T is the type of the adjust/instruction array iterator, which is advanced by jump operations. */
+template <typename U, typename S, typename T>
+static inline U EvalAdjustOperationT(const DeterministicSpriteGroupAdjust &adjust, ScopeResolver *scope, U last_value, uint32 value, T *adjust_iter)
+{
 	auto handle_jump = [&](bool jump, U jump_return_value) -> U {
 		if (jump && adjust_iter != nullptr) {
 			/* Jump */
@@ -240,6 +249,14 @@ static U EvalAdjustT(const DeterministicSpriteGroupAdjust &adjust, ScopeResolver
 	}
 }
 
+/* Evaluate an adjustment for a variable of the given size.
+ * U is the unsigned type and S is the signed type to use. */
+template <typename U, typename S>
+static U EvalAdjustT(const DeterministicSpriteGroupAdjust &adjust, ScopeResolver *scope, U last_value, uint32 value, const DeterministicSpriteGroupAdjust **adjust_iter = nullptr)
+{
+	return EvalAdjustOperationT<U, S>(adjust, scope, last_value, EvalAdjustValueT<U, S>(adjust, value), adjust_iter);
+}
+
 uint32 EvaluateDeterministicSpriteGroupAdjust(DeterministicSpriteGroupSize size, const DeterministicSpriteGroupAdjust &adjust, ScopeResolver *scope, uint32 last_value, uint32 value)
 {
 	switch (size) {
@@ -255,69 +272,187 @@ static bool RangeHighComparator(const DeterministicSpriteGroupRange& range, uint
 	return range.high < value;
 }
 
-const SpriteGroup *DeterministicSpriteGroup::Resolve(ResolverObject &object) const
+/**
+ * Resolve a procedure call (variable 0x7E) of a deterministic sprite group.
+ * @param group the calling group
+ * @param subroutine the group to call
+ * @param object the resolver object
+ * @return the callback result of the procedure
+ */
+static uint32 ResolveDeterministicSpriteGroupProcedure(const DeterministicSpriteGroup *group, const SpriteGroup *subroutine, ResolverObject &object)
 {
-	uint32 last_value = 0;
-	uint32 value = 0;
+	const Vehicle *relative_scope_vehicle = nullptr;
+	VarSpriteGroupScopeOffset relative_scope_cached_count = 0;
+	if (group->var_scope == VSG_SCOPE_RELATIVE) {
+		/* Save relative scope vehicle in case it will be changed during the procedure */
+		VehicleResolverObject *veh_object = dynamic_cast<VehicleResolverObject *>(&object);
+		if (veh_object != nullptr) {
+			relative_scope_vehicle = veh_object->relative_scope.v;
+			relative_scope_cached_count = veh_object->cached_relative_count;
+		}
+	}
 
-	ScopeResolver *scope = object.GetScope(this->var_scope, this->var_scope_count);
+	uint32 value;
+	const SpriteGroup *subgroup = SpriteGroup::Resolve(subroutine, object, false);
+	if (subgroup == nullptr) {
+		value = CALLBACK_FAILED;
+	} else {
+		value = subgroup->GetCallbackResult();
+	}
+
+	if (relative_scope_vehicle != nullptr) {
+		/* Reset relative scope vehicle in case it was changed during the procedure */
+		VehicleResolverObject *veh_object = static_cast<VehicleResolverObject *>(&object);
+		veh_object->relative_scope.v = relative_scope_vehicle;
+		veh_object->cached_relative_count = relative_scope_cached_count;
+	}
+
+	/* Note: 'last_value' and 'reseed' are shared between the main chain and the procedure */
+	return value;
+}
 
-	const DeterministicSpriteGroupAdjust *end = this->adjusts.data() + this->adjusts.size();
-	for (const DeterministicSpriteGroupAdjust *iter = this->adjusts.data(); iter != end; ++iter) {
-		const DeterministicSpriteGroupAdjust &adjust = *iter;
+/**
+ * Execute the compiled program of a deterministic sprite group, for a variable of the given size.
+ * U is the unsigned type and S is the signed type to use.
+ * @param group the group
+ * @param object the resolver object
+ * @param scope the scope of the group
+ * @param[out] last_value the accumulator
+ * @param[out] value the value of the last executed instruction
+ * @return false if an unsupported variable was read
+ */
+template <typename U, typename S>
+static bool ExecuteDeterministicSpriteGroupProgramT(const DeterministicSpriteGroup *group, ResolverObject &object, ScopeResolver *scope, uint32 &last_value, uint32 &value)
+{
+	const std::vector<DeterministicSpriteGroupInstruction> &instructions = group->program->instructions;
+	const DeterministicSpriteGroupInstruction *end = instructions.data() + instructions.size();
+	for (const DeterministicSpriteGroupInstruction *iter = instructions.data(); iter != end; ++iter) {
+		const DeterministicSpriteGroupAdjust &adjust = iter->adjust;
 
 		if ((adjust.adjust_flags & DSGAF_SKIP_ON_ZERO) && (last_value == 0)) continue;
 		if ((adjust.adjust_flags & DSGAF_SKIP_ON_LSB_SET) && (last_value & 1) != 0) continue;
 
-		/* Try to get the variable. We shall assume it is available, unless told otherwise. */
-		GetVariableExtra extra(adjust.and_mask << adjust.shift_num);
-		if (adjust.variable == 0x7E) {
-			const Vehicle *relative_scope_vehicle = nullptr;
-			VarSpriteGroupScopeOffset relative_scope_cached_count = 0;
-			if (this->var_scope == VSG_SCOPE_RELATIVE) {
-				/* Save relative scope vehicle in case it will be changed during the procedure */
-				VehicleResolverObject *veh_object = dynamic_cast<VehicleResolverObject *>(&object);
-				if (veh_object != nullptr) {
-					relative_scope_vehicle = veh_object->relative_scope.v;
-					relative_scope_cached_count = veh_object->cached_relative_count;
-				}
+		switch (iter->load) {
+			case DSGLK_CONSTANT:          value = iter->constant; break;
+			case DSGLK_CALLBACK:          value = object.callback; break;
+			case DSGLK_CALLBACK_PARAM1:   value = object.callback_param1; break;
+			case DSGLK_CALLBACK_PARAM2:   value = object.callback_param2; break;
+			case DSGLK_OBJECT_LAST_VALUE: value = object.last_value; break;
+			case DSGLK_RANDOM_TRIGGERS:   value = (scope->GetRandomBits() << 8) | scope->GetTriggers(); break;
+			case DSGLK_TEMP_STORE:        value = _temp_store.GetValue(adjust.parameter); break;
+			case DSGLK_GRF_PARAM:         value = (object.grffile == nullptr) ? 0 : object.grffile->GetParam(adjust.parameter); break;
+			case DSGLK_PROCEDURE:         value = ResolveDeterministicSpriteGroupProcedure(group, adjust.subroutine, object); break;
+
+			case DSGLK_SCOPE: {
+				GetVariableExtra extra(adjust.and_mask << adjust.shift_num);
+				value = scope->GetVariable(adjust.variable, adjust.parameter, &extra);
+				if (!extra.available) return false;
+				break;
 			}
 
-			const SpriteGroup *subgroup = SpriteGroup::Resolve(adjust.subroutine, object, false);
-			if (subgroup == nullptr) {
-				value = CALLBACK_FAILED;
-			} else {
-				value = subgroup->GetCallbackResult();
+			case DSGLK_INDIRECT: {
+				GetVariableExtra extra(adjust.and_mask << adjust.shift_num);
+				_sprite_group_resolve_check_veh_check = false;
+				value = GetVariable(object, scope, adjust.parameter, last_value, &extra);
+				if (!extra.available) return false;
+				break;
 			}
 
-			if (relative_scope_vehicle != nullptr) {
-				/* Reset relative scope vehicle in case it was changed during the procedure */
-				VehicleResolverObject *veh_object = static_cast<VehicleResolverObject *>(&object);
-				veh_object->relative_scope.v = relative_scope_vehicle;
-				veh_object->cached_relative_count = relative_scope_cached_count;
+			case DSGLK_GENERIC: {
+				GetVariableExtra extra(adjust.and_mask << adjust.shift_num);
+				value = GetVariable(object, scope, adjust.variable, adjust.parameter, &extra);
+				if (!extra.available) return false;
+				break;
 			}
 
-			/* Note: 'last_value' and 'reseed' are shared between the main chain and the procedure */
-		} else if (adjust.variable == 0x7B) {
-			_sprite_group_resolve_check_veh_check = false;
-			value = GetVariable(object, scope, adjust.parameter, last_value, &extra);
-		} else {
-			value = GetVariable(object, scope, adjust.variable, adjust.parameter, &extra);
+			default: NOT_REACHED();
 		}
 
-		if (!extra.available) {
+		if (iter->transform) value = EvalAdjustValueT<U, S>(adjust, value);
+		value = EvalAdjustOperationT<U, S>(adjust, scope, last_value, value, &iter);
+		last_value = value;
+	}
+
+	return true;
+}
+
+/**
+ * Get the group selected by the ranges of this group, or the default group.
+ * @param value the value to look up
+ * @return the selected group
+ */
+const SpriteGroup *DeterministicSpriteGroup::GetRangeGroup(uint32 value) const
+{
+	if (this->ranges.size() > 4) {
+		const auto &lower = std::lower_bound(this->ranges.begin(), this->ranges.end(), value, RangeHighComparator);
+		if (lower != this->ranges.end() && lower->low <= value) {
+			assert(lower->low <= value && value <= lower->high);
+			return lower->group;
+		}
+	} else {
+		for (const auto &range : this->ranges) {
+			if (range.low <= value && value <= range.high) {
+				return range.group;
+			}
+		}
+	}
+
+	return this->default_group;
+}
+
+const SpriteGroup *DeterministicSpriteGroup::Resolve(ResolverObject &object) const
+{
+	uint32 last_value = 0;
+	uint32 value = 0;
+
+	ScopeResolver *scope = object.GetScope(this->var_scope, this->var_scope_count);
+
+	if (this->program != nullptr) {
+		bool ok;
+		switch (this->size) {
+			case DSG_SIZE_BYTE:  ok = ExecuteDeterministicSpriteGroupProgramT<uint8,  int8> (this, object, scope, last_value, value); break;
+			case DSG_SIZE_WORD:  ok = ExecuteDeterministicSpriteGroupProgramT<uint16, int16>(this, object, scope, last_value, value); break;
+			case DSG_SIZE_DWORD: ok = ExecuteDeterministicSpriteGroupProgramT<uint32, int32>(this, object, scope, last_value, value); break;
+			default: NOT_REACHED();
+		}
+		if (!ok) {
 			/* Unsupported variable: skip further processing and return either
 			 * the group from the first range or the default group. */
 			return SpriteGroup::Resolve(this->error_group, object, false);
 		}
+	} else {
+		const DeterministicSpriteGroupAdjust *end = this->adjusts.data() + this->adjusts.size();
+		for (const DeterministicSpriteGroupAdjust *iter = this->adjusts.data(); iter != end; ++iter) {
+			const DeterministicSpriteGroupAdjust &adjust = *iter;
+
+			if ((adjust.adjust_flags & DSGAF_SKIP_ON_ZERO) && (last_value == 0)) continue;
+			if ((adjust.adjust_flags & DSGAF_SKIP_ON_LSB_SET) && (last_value & 1) != 0) continue;
+
+			/* Try to get the variable. We shall assume it is available, unless told otherwise. */
+			GetVariableExtra extra(adjust.and_mask << adjust.shift_num);
+			if (adjust.variable == 0x7E) {
+				value = ResolveDeterministicSpriteGroupProcedure(this, adjust.subroutine, object);
+			} else if (adjust.variable == 0x7B) {
+				_sprite_group_resolve_check_veh_check = false;
+				value = GetVariable(object, scope, adjust.parameter, last_value, &extra);
+			} else {
+				value = GetVariable(object, scope, adjust.variable, adjust.parameter, &extra);
+			}
 
-		switch (this->size) {
-			case DSG_SIZE_BYTE:  value = EvalAdjustT<uint8,  int8> (adjust, scope, last_value, value, &iter); break;
-			case DSG_SIZE_WORD:  value = EvalAdjustT<uint16, int16>(adjust, scope, last_value, value, &iter); break;
-			case DSG_SIZE_DWORD: value = EvalAdjustT<uint32, int32>(adjust, scope, last_value, value, &iter); break;
-			default: NOT_REACHED();
+			if (!extra.available) {
+				/* Unsupported variable: skip further processing and return either
+				 * the group from the first range or the default group. */
+				return SpriteGroup::Resolve(this->error_group, object, false);
+			}
+
+			switch (this->size) {
+				case DSG_SIZE_BYTE:  value = EvalAdjustT<uint8,  int8> (adjust, scope, last_value, value, &iter); break;
+				case DSG_SIZE_WORD:  value = EvalAdjustT<uint16, int16>(adjust, scope, last_value, value, &iter); break;
+				case DSG_SIZE_DWORD: value = EvalAdjustT<uint32, int32>(adjust, scope, last_value, value, &iter); break;
+				default: NOT_REACHED();
+			}
+			last_value = value;
 		}
-		last_value = value;
 	}
 
 	object.last_value = last_value;
@@ -330,21 +465,94 @@ const SpriteGroup *DeterministicSpriteGroup::Resolve(ResolverObject &object) con
 		return &nvarzero;
 	}
 
-	if (this->ranges.size() > 4) {
-		const auto &lower = std::lower_bound(this->ranges.begin(), this->ranges.end(), value, RangeHighComparator);
-		if (lower != this->ranges.end() && lower->low <= value) {
-			assert(lower->low <= value && value <= lower->high);
-			return SpriteGroup::Resolve(lower->group, object, false);
-		}
-	} else {
-		for (const auto &range : this->ranges) {
-			if (range.low <= value && value <= range.high) {
-				return SpriteGroup::Resolve(range.group, object, false);
-			}
+	if (this->program != nullptr && !this->program->range_table.empty()) {
+		/* Values outside the table are not in any range */
+		const uint32 offset = value - this->program->range_table_base;
+		return SpriteGroup::Resolve(offset < this->program->range_table.size() ? this->program->range_table[offset] : this->default_group, object, false);
+	}
+
+	return SpriteGroup::Resolve(this->GetRangeGroup(value), object, false);
+}
+
+/** Maximum number of entries of the direct lookup table of the ranges of a compiled deterministic sprite group. */
+static const uint MAX_DSG_RANGE_TABLE_SIZE = 256;
+
+/**
+ * Decode the adjusts and ranges of this group into a program, which is executed by Resolve instead of the adjusts.
+ * This must be called after the adjusts and ranges are final.
+ */
+void DeterministicSpriteGroup::CompileProgram()
+{
+	this->program.reset(new DeterministicSpriteGroupProgram());
+	this->program->instructions.reserve(this->adjusts.size());
+
+	for (const DeterministicSpriteGroupAdjust &adjust : this->adjusts) {
+		DeterministicSpriteGroupInstruction &insn = this->program->instructions.emplace_back();
+		insn.adjust = adjust;
+		insn.constant = 0;
+		insn.transform = (adjust.shift_num != 0 || adjust.and_mask != 0xFFFFFFFF || adjust.type != DSGA_TYPE_NONE);
+
+		switch (adjust.variable) {
+			case 0x0C: insn.load = DSGLK_CALLBACK; break;
+			case 0x10: insn.load = DSGLK_CALLBACK_PARAM1; break;
+			case 0x18: insn.load = DSGLK_CALLBACK_PARAM2; break;
+			case 0x1C: insn.load = DSGLK_OBJECT_LAST_VALUE; break;
+			case 0x5F: insn.load = DSGLK_RANDOM_TRIGGERS; break;
+			case 0x7B: insn.load = DSGLK_INDIRECT; break;
+			case 0x7D: insn.load = DSGLK_TEMP_STORE; break;
+			case 0x7E: insn.load = DSGLK_PROCEDURE; break;
+			case 0x7F: insn.load = DSGLK_GRF_PARAM; break;
+
+			case 0x1A:
+				if ((adjust.type == DSGA_TYPE_DIV || adjust.type == DSGA_TYPE_MOD) && adjust.divmod_val == 0) {
+					/* Don't fold a division by zero, only fail if the adjustment is actually evaluated, as when not compiled. */
+					insn.load = DSGLK_GENERIC;
+					break;
+				}
+				insn.load = DSGLK_CONSTANT;
+				switch (this->size) {
+					case DSG_SIZE_BYTE:  insn.constant = EvalAdjustValueT<uint8,  int8> (adjust, UINT_MAX); break;
+					case DSG_SIZE_WORD:  insn.constant = EvalAdjustValueT<uint16, int16>(adjust, UINT_MAX); break;
+					case DSG_SIZE_DWORD: insn.constant = EvalAdjustValueT<uint32, int32>(adjust, UINT_MAX); break;
+					default: NOT_REACHED();
+				}
+				insn.transform = false;
+				break;
+
+			default:
+				insn.load = (adjust.variable < 0x40) ? DSGLK_GENERIC : DSGLK_SCOPE;
+				break;
 		}
 	}
 
-	return SpriteGroup::Resolve(this->default_group, object, false);
+	if (this->calculated_result || this->ranges.empty()) return;
+
+	uint32 low = UINT32_MAX;
+	uint32 high = 0;
+	for (const auto &range : this->ranges) {
+		low = std::min(low, range.low);
+		high = std::max(high, range.high);
+	}
+	if (high < low || high - low >= MAX_DSG_RANGE_TABLE_SIZE) return;
+
+	this->program->range_table_base = low;
+	this->program->range_table.resize(high - low + 1);
+	for (uint32 i = 0; i <= high - low; i++) {
+		this->program->range_table[i] = this->GetRangeGroup(low + i);
+	}
+}
+
+/**
+ * Compile all deterministic sprite groups, see DeterministicSpriteGroup::CompileProgram.
+ * This is called after all NewGRFs have been loaded and optimised.
+ */
+void CompileDeterministicSpriteGroupPrograms()
+{
+	if (HasGrfOptimiserFlag(NGOF_NO_VARACT2_PROGRAM)) return;
+
+	for (SpriteGroup *sg : SpriteGroup::Iterate()) {
+		if (sg->type == SGT_DETERMINISTIC) static_cast<DeterministicSpriteGroup *>(sg)->CompileProgram();
+	}
 }
 
 bool DeterministicSpriteGroup::GroupMayBeBypassed() const
@@ -23,6 +23,7 @@
 #include "3rdparty/cpp-btree/btree_set.h"
 
 #include <map>
+#include <memory>
 
 /**
  * Gets the value of a so-called newgrf "register".
@@ -104,6 +105,8 @@ struct RealSpriteGroup : SpriteGroup {
 	std::vector<const SpriteGroup *> loaded;  ///< List of loaded groups (can be SpriteIDs or Callback results)
 	std::vector<const SpriteGroup *> loading; ///< List of loading groups (can be SpriteIDs or Callback results)
 
+	void AnalyseCallbacks(AnalyseCallbackOperation &op) const override;
+
 protected:
 	const SpriteGroup *Resolve(ResolverObject &object) const override;
 };
@@ -486,6 +489,37 @@ struct DeterministicSpriteGroupShadowCopy {
 	bool calculated_result;
 };
 
+/** Source of the value of a #DeterministicSpriteGroupInstruction, decoded from the variable number of the adjust. */
+enum DeterministicSpriteGroupLoadKind : uint8 {
+	DSGLK_GENERIC,                ///< Common or scope variable, via the full variable lookup
+	DSGLK_SCOPE,                  ///< Scope variable (0x40 and above), via ScopeResolver::GetVariable
+	DSGLK_CONSTANT,               ///< Constant (variable 0x1A), folded with the shift, mask and type of the adjust
+	DSGLK_CALLBACK,               ///< Variable 0x0C
+	DSGLK_CALLBACK_PARAM1,        ///< Variable 0x10
+	DSGLK_CALLBACK_PARAM2,        ///< Variable 0x18
+	DSGLK_OBJECT_LAST_VALUE,      ///< Variable 0x1C
+	DSGLK_RANDOM_TRIGGERS,        ///< Variable 0x5F
+	DSGLK_TEMP_STORE,             ///< Variable 0x7D
+	DSGLK_GRF_PARAM,              ///< Variable 0x7F
+	DSGLK_PROCEDURE,              ///< Variable 0x7E
+	DSGLK_INDIRECT,               ///< Variable 0x7B
+};
+
+/** Decoded form of a #DeterministicSpriteGroupAdjust, as executed by DeterministicSpriteGroup::Resolve. */
+struct DeterministicSpriteGroupInstruction {
+	DeterministicSpriteGroupAdjust adjust;
+	uint32 constant;                       ///< Loaded value for DSGLK_CONSTANT, after applying the shift, mask and type of the adjust
+	DeterministicSpriteGroupLoadKind load;
+	bool transform;                        ///< Whether the shift, mask and type of the adjust are not a no-op
+};
+
+/** Decoded form of a #DeterministicSpriteGroup, this is generated after all NewGRFs have been loaded. */
+struct DeterministicSpriteGroupProgram {
+	std::vector<DeterministicSpriteGroupInstruction> instructions; ///< One instruction per adjust, such that jump offsets are unchanged
+	std::vector<const SpriteGroup *> range_table;                   ///< Result group of each value from range_table_base, if not empty
+	uint32 range_table_base = 0;
+};
+
 struct DeterministicSpriteGroup : SpriteGroup {
 	DeterministicSpriteGroup() : SpriteGroup(SGT_DETERMINISTIC) {}
 
@@ -502,11 +536,17 @@ struct DeterministicSpriteGroup : SpriteGroup {
 
 	const SpriteGroup *error_group; // was first range, before sorting ranges
 
+	std::unique_ptr<DeterministicSpriteGroupProgram> program; ///< Decoded adjusts and ranges, if compiled
+
 	void AnalyseCallbacks(AnalyseCallbackOperation &op) const override;
 	bool GroupMayBeBypassed() const;
+	void CompileProgram();
 
 protected:
 	const SpriteGroup *Resolve(ResolverObject &object) const override;
+
+private:
+	const SpriteGroup *GetRangeGroup(uint32 value) const;
 };
 
 enum RandomizedSpriteGroupCompareMode : uint8 {
@@ -793,6 +833,7 @@ public:
 };
 
 void DumpSpriteGroup(const SpriteGroup *sg, DumpSpriteGroupPrinter print);
+void CompileDeterministicSpriteGroupPrograms();
 uint32 EvaluateDeterministicSpriteGroupAdjust(DeterministicSpriteGroupSize size, const DeterministicSpriteGroupAdjust &adjust, ScopeResolver *scope, uint32 last_value, uint32 value);
 
 #endif /* NEWGRF_SPRITEGROUP_H */
@@ -84,6 +84,7 @@
 #include "debug_desync.h"
 #include "event_logs.h"
 #include "tunnelbridge.h"
+#include "water_map.h"
 #include "worker_thread.h"
 #include "scope_info.h"
 #include "network/network_survey.h"
@@ -472,6 +473,7 @@ static void ShutdownGame()
 
 	FreeSignalPrograms();
 	FreeSignalDependencies();
+	ClearSignalSegmentCache();
 
 	extern void ClearNewSignalStyleMapping();
 	ClearNewSignalStyleMapping();
@@ -1019,13 +1021,16 @@ int openttd_main(int argc, char *argv[])
 	RequestNewGRFScan(scanner.release());
 
 	_general_worker_pool.Start("ottd:worker", 8);
+	_link_graph_worker_pool.Start("ottd:lg-worker", std::min<uint>(4, std::thread::hardware_concurrency() / 2));
 
 	VideoDriver::GetInstance()->MainLoop();
 
-	_general_worker_pool.Stop();
-
+	/* The save thread compresses on the general worker pool. */
 	WaitTillSaved();
 
+	_general_worker_pool.Stop();
+	_link_graph_worker_pool.Stop();
+
 	/* only save config if we have to */
 	if (_save_config) {
 		SaveToConfig();
@@ -1581,6 +1586,8 @@ void CheckCaches(bool force_check, std::function<void(const char *)> log, CheckC
 			old_industry_stations_nears.push_back(ind->stations_near);
 		}
 
+		std::vector<std::vector<StationCatchmentIndex::Entry>> old_station_catchment_index = _station_catchment_index.blocks;
+
 		RebuildTownCaches(false, false);
 		RebuildSubsidisedSourceAndDestinationCache();
 
@@ -1621,6 +1628,9 @@ void CheckCaches(bool force_check, std::function<void(const char *)> log, CheckC
 			}
 			i++;
 		}
+		if (old_station_catchment_index != _station_catchment_index.blocks) {
+			CCLOG("station catchment index mismatch: (old blocks: %u, new blocks: %u)", (uint)old_station_catchment_index.size(), (uint)_station_catchment_index.blocks.size());
+		}
 		i = 0;
 		for (Industry *ind : Industry::Iterate()) {
 			if (old_industry_stations_nears[i] != ind->stations_near) {
@@ -1677,6 +1687,19 @@ void CheckCaches(bool force_check, std::function<void(const char *)> log, CheckC
 	}
 
 	if (flags & CHECK_CACHE_GENERAL) {
+		/* Check the non-flooding water tile bitmap. */
+		const TileIndex map_size = MapSize();
+		for (TileIndex t = 0; t < map_size; t++) {
+			if (HasNonFloodingWaterTileBit(t) != IsNonFloodingWaterTile(t)) {
+				CCLOG("non-flooding water tile bitmap mismatch: tile: 0x%X (%u x %u)", t, TileX(t), TileY(t));
+				break;
+			}
+		}
+
+		/* Check the signal segment cache against fresh explorations. */
+		uint signal_segment_mismatches = ValidateSignalSegmentCache();
+		if (signal_segment_mismatches > 0) CCLOG("signal segment cache mismatches: %u", signal_segment_mismatches);
+
 		/* Strict checking of the road stop cache entries */
 		for (const RoadStop *rs : RoadStop::Iterate()) {
 			if (IsStandardRoadStopTile(rs->xy)) continue;
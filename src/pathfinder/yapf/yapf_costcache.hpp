@@ -11,6 +11,10 @@
 #define YAPF_COSTCACHE_HPP
 
 #include "../../date_func.h"
+#include "../../tilearea_type.h"
+#include "../../thread.h"
+#include <algorithm>
+#include <vector>
 
 /**
  * CYapfSegmentCostCacheNoneT - the formal only yapf cost cache provider that implements
@@ -90,20 +94,102 @@ public:
 };
 
 
+/** Statistics of the global segment cost caches. */
+struct CSegmentCostCacheStats
+{
+	uint64 hits = 0;                 ///< number of segment lookups which found cached data
+	uint64 misses = 0;               ///< number of segment lookups which had to create a new cache entry
+	uint64 invalidated_segments = 0; ///< number of cached segments dropped because a tile they depend on changed
+	uint64 flushes = 0;              ///< number of non-empty caches flushed completely
+	uint64 queue_overflows = 0;      ///< number of times MAX_INVALIDATED_AREAS queued changed areas were dropped, as not all caches had processed them
+};
+
 /**
  * Base class for segment cost cache providers. Contains global counter
  *  of track layout changes and static notification function called whenever
  *  the track layout changes. It is implemented as base class because it needs
  *  to be shared between all rail YAPF types (one shared counter, one notification
  *  function.
+ *
+ * Changes of a single tile, and path reservations, are queued as areas in s_invalidated_areas,
+ *  so that each cache only drops the segments which depend on tiles in those areas.
+ *  Changes without a tile increment the counter which flushes the whole cache.
+ *  Queued areas are numbered by sequence numbers which are never reused, the areas which all caches
+ *  have processed are removed from the front of the queue.
+ *  At most MAX_INVALIDATED_AREAS areas are queued, as each queued area is checked against
+ *  every cached segment. When a cache which has not been used for a while holds back that many,
+ *  the queue is cleared and that cache is flushed when it is next used, these clears are counted
+ *  separately in the statistics shown by dump_yapf_cache_stats.
  */
 struct CSegmentCostCacheBase
 {
+	static const uint MAX_INVALIDATED_AREAS = 256; ///< queued changed areas after which a full flush is cheaper
+
 	static int   s_rail_change_counter;
+	static std::vector<TileArea> s_invalidated_areas;
+	static uint64 s_invalidated_areas_base;              ///< sequence number of the first item of s_invalidated_areas
+	static std::vector<CSegmentCostCacheBase *> s_caches; ///< all segment cost caches, to find the queued areas which all of them have processed
+	static CSegmentCostCacheStats s_stats;
+
+	uint64 m_invalidated_areas_seen; ///< sequence number of the first item of s_invalidated_areas not yet processed by this cache
+
+	CSegmentCostCacheBase() : m_invalidated_areas_seen(GetInvalidatedAreasEnd())
+	{
+		s_caches.push_back(this);
+	}
+
+	~CSegmentCostCacheBase()
+	{
+		s_caches.erase(std::find(s_caches.begin(), s_caches.end(), this));
+	}
+
+	CSegmentCostCacheBase(const CSegmentCostCacheBase &) = delete;
+	CSegmentCostCacheBase &operator=(const CSegmentCostCacheBase &) = delete;
+
+	/** @return sequence number of the next area to be queued */
+	static uint64 GetInvalidatedAreasEnd()
+	{
+		return s_invalidated_areas_base + s_invalidated_areas.size();
+	}
+
+	/**
+	 * Remove queued areas from the front of the queue.
+	 * @param end sequence number of the first area to keep
+	 */
+	static void DropInvalidatedAreas(uint64 end)
+	{
+		s_invalidated_areas.erase(s_invalidated_areas.begin(), s_invalidated_areas.begin() + (size_t)(end - s_invalidated_areas_base));
+		s_invalidated_areas_base = end;
+	}
+
+	/** Remove the queued areas which all caches have processed. */
+	static void TrimInvalidatedAreas()
+	{
+		uint64 end = GetInvalidatedAreasEnd();
+		for (const CSegmentCostCacheBase *cache : s_caches) {
+			end = std::min(end, cache->m_invalidated_areas_seen);
+		}
+		if (end > s_invalidated_areas_base) DropInvalidatedAreas(end);
+	}
 
 	static void NotifyTrackLayoutChange(TileIndex tile, Track track)
 	{
-		s_rail_change_counter++;
+		if (tile == INVALID_TILE) {
+			s_rail_change_counter++;
+			DropInvalidatedAreas(GetInvalidatedAreasEnd());
+		} else {
+			NotifyAreaChange(TileArea(tile, 1, 1));
+		}
+	}
+
+	static void NotifyAreaChange(const TileArea &area)
+	{
+		if (s_invalidated_areas.size() >= MAX_INVALIDATED_AREAS) {
+			/* Caches which have not processed the dropped areas flush themselves when next used. */
+			s_stats.queue_overflows++;
+			DropInvalidatedAreas(GetInvalidatedAreasEnd());
+		}
+		s_invalidated_areas.push_back(area);
 	}
 };
 
@@ -128,6 +214,8 @@ struct CSegmentCostCacheT : public CSegmentCostCacheBase {
 
 	HashTable    m_map;
 	Heap         m_heap;
+	uint         m_dead_items = 0;              ///< number of items in m_heap which have been removed from m_map
+	int          m_last_rail_change_counter = s_rail_change_counter; ///< value of s_rail_change_counter when this cache was last updated
 
 	inline CSegmentCostCacheT() {}
 
@@ -136,6 +224,7 @@ struct CSegmentCostCacheT : public CSegmentCostCacheBase {
 	{
 		m_map.Clear();
 		m_heap.Clear();
+		m_dead_items = 0;
 	}
 
 	inline Tsegment& Get(Key &key, bool *found)
@@ -150,6 +239,48 @@ struct CSegmentCostCacheT : public CSegmentCostCacheBase {
 		}
 		return *item;
 	}
+
+	/**
+	 * Drop the cached segments affected by the track layout changes notified since the last call.
+	 * This must not be called while any node refers to data in this cache.
+	 */
+	void ProcessTrackLayoutChanges()
+	{
+		if (m_last_rail_change_counter != s_rail_change_counter || m_invalidated_areas_seen < s_invalidated_areas_base) {
+			m_last_rail_change_counter = s_rail_change_counter;
+			m_invalidated_areas_seen = GetInvalidatedAreasEnd();
+			if (m_map.Count() > 0) s_stats.flushes++;
+			Flush();
+			TrimInvalidatedAreas();
+			return;
+		}
+
+		if (m_invalidated_areas_seen == GetInvalidatedAreasEnd()) return;
+
+		const TileArea *first = s_invalidated_areas.data() + (size_t)(m_invalidated_areas_seen - s_invalidated_areas_base);
+		const TileArea *last = s_invalidated_areas.data() + s_invalidated_areas.size();
+		m_invalidated_areas_seen = GetInvalidatedAreasEnd();
+
+		uint invalidated = 0;
+		for (uint i = 0; i < m_heap.Length(); i++) {
+			Tsegment &item = m_heap[i];
+			if (m_map.Find(item.GetKey()) != &item) continue; // already removed
+			for (const TileArea *area = first; area != last; area++) {
+				if (item.IsAffectedByArea(*area)) {
+					m_map.Pop(item);
+					invalidated++;
+					break;
+				}
+			}
+		}
+		m_dead_items += invalidated;
+		s_stats.invalidated_segments += invalidated;
+
+		/* The heap storage cannot be reused item by item, so flush once most of it is unused. */
+		if (m_dead_items > m_heap.Length() / 2) Flush();
+
+		TrimInvalidatedAreas();
+	}
 };
 
 /**
@@ -169,9 +300,9 @@ public:
 	typedef CSegmentCostCacheT<CachedData> Cache;
 
 protected:
-	Cache &m_global_cache;
+	Cache *m_global_cache; ///< nullptr on worker threads, these only run searches with the cache disabled
 
-	inline CYapfSegmentCostCacheGlobalT() : m_global_cache(stGetGlobalCache()) {};
+	inline CYapfSegmentCostCacheGlobalT() : m_global_cache((IsNonMainThread() && IsNonGameThread()) ? nullptr : &stGetGlobalCache()) {};
 
 	/** to access inherited path finder */
 	inline Tpf& Yapf()
@@ -181,14 +312,10 @@ protected:
 
 	inline static Cache& stGetGlobalCache()
 	{
-		static int last_rail_change_counter = 0;
 		static Cache C;
 
-		/* delete the cache sometimes... */
-		if (last_rail_change_counter != Cache::s_rail_change_counter) {
-			last_rail_change_counter = Cache::s_rail_change_counter;
-			C.Flush();
-		}
+		/* drop the segments invalidated by track layout changes */
+		C.ProcessTrackLayoutChanges();
 		return C;
 	}
 
@@ -202,10 +329,12 @@ public:
 		if (!Yapf().CanUseGlobalCache(n)) {
 			return Tlocal::PfNodeCacheFetch(n);
 		}
+		dbg_assert(m_global_cache != nullptr);
 		CacheKey key(n.GetKey());
 		bool found;
-		CachedData &item = m_global_cache.Get(key, &found);
+		CachedData &item = m_global_cache->Get(key, &found);
 		Yapf().ConnectNodeToCachedData(n, item);
+		(found ? Cache::s_stats.hits : Cache::s_stats.misses)++;
 		return found;
 	}
 
@@ -614,6 +614,9 @@ public:
 
 no_entry_cost: // jump here at the beginning if the node has no parent (it is the first node)
 
+			/* Remember which tiles the segment depends on, so that it can be invalidated by changes of those tiles. */
+			if (!is_cached_segment) segment.AddTile(cur.tile);
+
 			/* All other tile costs will be calculated here. */
 			segment_cost += Yapf().OneTileCost(cur.tile, cur.td);
 
@@ -746,6 +749,9 @@ no_entry_cost: // jump here at the beginning if the node has no parent (it is th
 				break;
 			}
 
+			/* The next tile (which may be the far end of a tunnel or bridge) is inspected as well. */
+			if (!is_cached_segment) segment.AddTile(tf_local.m_new_tile);
+
 			/* Check if the next tile is not a choice. */
 			if (KillFirstBit(tf_local.m_new_td_bits) != TRACKDIR_BIT_NONE) {
 				/* More than one segment will follow. Close this one. */
@@ -69,6 +69,10 @@ struct CYapfRailSegment
 	TileIndex              m_last_signal_tile;
 	Trackdir               m_last_signal_td;
 	EndSegmentReasonBits   m_end_segment_reason;
+	uint                   m_min_x;  ///< bounding box of the tiles the segment cost depends on
+	uint                   m_min_y;
+	uint                   m_max_x;
+	uint                   m_max_y;
 	CYapfRailSegment      *m_hash_next;
 
 	inline CYapfRailSegment(const CYapfRailSegmentKey &key)
@@ -79,6 +83,10 @@ struct CYapfRailSegment
 		, m_last_signal_tile(INVALID_TILE)
 		, m_last_signal_td(INVALID_TRACKDIR)
 		, m_end_segment_reason(ESRB_NONE)
+		, m_min_x(UINT_MAX)
+		, m_min_y(UINT_MAX)
+		, m_max_x(0)
+		, m_max_y(0)
 		, m_hash_next(nullptr)
 	{}
 
@@ -97,6 +105,33 @@ struct CYapfRailSegment
 		return m_hash_next;
 	}
 
+	/**
+	 * Extend the area the segment cost depends on by a tile which was walked or inspected.
+	 * @param tile the tile
+	 */
+	inline void AddTile(TileIndex tile)
+	{
+		uint x = TileX(tile);
+		uint y = TileY(tile);
+		m_min_x = std::min(m_min_x, x);
+		m_min_y = std::min(m_min_y, y);
+		m_max_x = std::max(m_max_x, x);
+		m_max_y = std::max(m_max_y, y);
+	}
+
+	/**
+	 * Check whether a change of tiles in the given area may change the cached segment.
+	 * The neighbours of the segment tiles are included, as the track follower looks at them to find the end of the segment.
+	 * @param area the changed area
+	 * @return true if the segment has to be recalculated
+	 */
+	inline bool IsAffectedByArea(const TileArea &area) const
+	{
+		uint x = TileX(area.tile);
+		uint y = TileY(area.tile);
+		return x + area.w >= m_min_x && x <= m_max_x + 1 && y + area.h >= m_min_y && y <= m_max_y + 1;
+	}
+
 	inline void SetHashNext(CYapfRailSegment *next)
 	{
 		m_hash_next = next;
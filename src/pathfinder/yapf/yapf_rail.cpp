@@ -17,6 +17,7 @@
 #include "../../viewport_func.h"
 #include "../../newgrf_station.h"
 #include "../../tracerestrict.h"
+#include "../../signal_func.h"
 #include "../../debug.h"
 
 #include "../../safeguards.h"
@@ -85,6 +86,8 @@ private:
 	TileIndex m_res_fail_tile;    ///< The tile where the reservation failed
 	Trackdir  m_res_fail_td;      ///< The trackdir where the reservation failed
 	TileIndex m_origin_tile;      ///< Tile our reservation will originate from
+	TileArea  m_res_area;         ///< Area of the tiles reserved for the current node
+	std::vector<TileArea> m_res_areas; ///< Areas of the tiles reserved for each node of the path
 
 	bool FindSafePositionProc(TileIndex tile, Trackdir td)
 	{
@@ -105,6 +108,7 @@ private:
 		do {
 			if (HasStationReservation(tile)) return false;
 			SetRailStationReservation(tile, true);
+			m_res_area.Add(tile);
 			MarkTileDirtyByTile(tile, VMDF_NOT_MAP_MODE);
 			tile = TILE_ADD(tile, diff);
 		} while (IsCompatibleTrainStationTile(tile, start) && tile != m_origin_tile);
@@ -117,6 +121,7 @@ private:
 	/** Try to reserve a single track/platform. */
 	bool ReserveSingleTrack(TileIndex tile, Trackdir td)
 	{
+		m_res_area.Add(tile);
 		if (IsRailStationTile(tile)) {
 			if (!ReserveRailStationPlatform(tile, TrackdirToExitdir(ReverseTrackdir(td)))) {
 				/* Platform could not be reserved, undo. */
@@ -189,8 +194,11 @@ public:
 		PBSWaitingPositionRestrictedSignalInfo restricted_signal_info;
 		if (!IsWaitingPositionFree(Yapf().GetVehicle(), m_res_dest, m_res_dest_td, false, &restricted_signal_info)) return false;
 
+		m_res_areas.clear();
 		for (Node *node = m_res_node; node->m_parent != nullptr; node = node->m_parent) {
+			m_res_area = TileArea();
 			node->IterateTiles(Yapf().GetVehicle(), Yapf(), *this, &CYapfReserveTrack<Types>::ReserveSingleTrack);
+			m_res_areas.push_back(m_res_area);
 			if (m_res_fail_tile != INVALID_TILE) {
 				/* Reservation failed, undo. */
 				Node *fail_node = m_res_node;
@@ -220,7 +228,10 @@ public:
 		if (target != nullptr) target->okay = true;
 
 		if (Yapf().CanUseGlobalCache(*m_res_node)) {
-			YapfNotifyTrackLayoutChange(INVALID_TILE, INVALID_TRACK);
+			/* Segment costs include reservation penalties, drop only the segments near the newly reserved tiles. */
+			for (const TileArea &area : m_res_areas) {
+				CSegmentCostCacheBase::NotifyAreaChange(area);
+			}
 		}
 
 		return true;
@@ -783,10 +794,32 @@ bool YapfTrainFindNearestSafeTile(const Train *v, TileIndex tile, Trackdir td, b
 
 /** if any track changes, this counter is incremented - that will invalidate segment cost cache */
 int CSegmentCostCacheBase::s_rail_change_counter = 0;
+/** areas changed since the last increment of s_rail_change_counter - segments depending on tiles in these are dropped from the segment cost cache */
+std::vector<TileArea> CSegmentCostCacheBase::s_invalidated_areas;
+uint64 CSegmentCostCacheBase::s_invalidated_areas_base = 0;
+std::vector<CSegmentCostCacheBase *> CSegmentCostCacheBase::s_caches;
+CSegmentCostCacheStats CSegmentCostCacheBase::s_stats;
 
 void YapfNotifyTrackLayoutChange(TileIndex tile, Track track)
 {
 	CSegmentCostCacheBase::NotifyTrackLayoutChange(tile, track);
+	NotifySignalSegmentLayoutChanged();
+}
+
+void DumpYapfRailSegmentCostCacheStats(char *buffer, const char *last)
+{
+	const CSegmentCostCacheStats &stats = CSegmentCostCacheBase::s_stats;
+	const uint64 hits = stats.hits;
+	const uint64 misses = stats.misses;
+	buffer += seprintf(buffer, last, "Rail segment cost cache:\n");
+	buffer += seprintf(buffer, last, "  Hits: " OTTD_PRINTF64U ", misses: " OTTD_PRINTF64U ", hit rate: %.1f%%\n",
+			hits, misses, hits + misses > 0 ? (100.0 * hits) / (hits + misses) : 0.0);
+	buffer += seprintf(buffer, last, "  Invalidated segments: " OTTD_PRINTF64U ", full flushes: " OTTD_PRINTF64U "\n",
+			stats.invalidated_segments, stats.flushes);
+	buffer += seprintf(buffer, last, "  Queue clears due to %u changed areas not processed by all caches: " OTTD_PRINTF64U "\n",
+			CSegmentCostCacheBase::MAX_INVALIDATED_AREAS, stats.queue_overflows);
+	buffer += seprintf(buffer, last, "  Queued changed areas: " PRINTF_SIZE " / %u\n",
+			CSegmentCostCacheBase::s_invalidated_areas.size(), CSegmentCostCacheBase::MAX_INVALIDATED_AREAS);
 }
 
 void YapfCheckRailSignalPenalties()
@@ -27,6 +27,7 @@
 #include "../roadveh.h"
 #include "../train.h"
 #include "../station_base.h"
+#include "../station_func.h"
 #include "../waypoint_base.h"
 #include "../roadstop_base.h"
 #include "../tunnelbridge.h"
@@ -665,6 +666,9 @@ bool AfterLoadGame()
 {
 	SetSignalHandlers();
 
+	/* The map is converted below, so do not cache any signal segments until it is done. */
+	SignalSegmentCacheSuspender signal_cache_suspend;
+
 	TileIndex map_size = MapSize();
 
 	extern TileIndex _cur_tileloop_tile; // From landscape.cpp.
@@ -679,6 +683,9 @@ bool AfterLoadGame()
 	GamelogTestRevision();
 	GamelogTestMode();
 
+	/* The vehicle tile hash was sized for the map before it was loaded, size it for the loaded map before vehicles are hashed. */
+	ResetVehicleHash();
+
 	RebuildTownKdtree();
 	RebuildStationKdtree();
 	UpdateCachedSnowLine();
@@ -4209,6 +4216,14 @@ bool AfterLoadGame()
 		_settings_game.economy.tick_rate = IsSavegameVersionUntil(SLV_MORE_CARGO_AGE) ? TRM_TRADITIONAL : TRM_MODERN;
 	}
 
+	if (SlXvIsFeatureMissing(XSLFI_STATION_RATING_PHASE)) {
+		/* Spread the rating updates of existing stations, as for new stations.
+		 * Stations which are not in use keep their delete countdown. */
+		for (Station *st : Station::Iterate()) {
+			if (st->IsInUse()) InitStationRatingUpdateCounter(st);
+		}
+	}
+
 	if (SlXvIsFeatureMissing(XSLFI_AI_START_DATE) && IsSavegameVersionBefore(SLV_AI_START_DATE)) {
 		/* For older savegames, we don't now the actual interval; so set it to the newgame value. */
 		_settings_game.difficulty.competitors_interval = _settings_newgame.difficulty.competitors_interval;
@@ -4241,6 +4256,8 @@ bool AfterLoadGame()
 
 	SetupTickRate();
 
+	RebuildNonFloodingWaterTileBits();
+
 	InitializeWindowsAndCaches();
 	/* Restore the signals */
 	ResetSignalHandlers();
@@ -4345,6 +4362,8 @@ void ReloadNewGRFData()
 	GroupStatistics::UpdateAfterLoad();
 	/* update station graphics */
 	AfterLoadStations();
+	/* which station tiles are blocked depends on the station specs */
+	NotifySignalSegmentLayoutChanged();
 
 	RailType rail_type_translate_map[RAILTYPE_END];
 	for (RailType old_type = RAILTYPE_BEGIN; old_type != RAILTYPE_END; old_type++) {
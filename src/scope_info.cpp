@@ -24,7 +24,8 @@
 
 #ifdef USE_SCOPE_INFO
 
-std::vector<std::function<int(char *, const char *)>> _scope_stack;
+/** Scope stack of the current thread, worker threads may push scopes while running game state code, e.g. AI scripts. */
+thread_local std::vector<std::function<int(char *, const char *)>> _scope_stack;
 
 int WriteScopeLog(char *buf, const char *last)
 {
@@ -21,7 +21,7 @@ struct Window;
 
 #ifdef USE_SCOPE_INFO
 
-extern std::vector<std::function<int(char *, const char *)>> _scope_stack;
+extern thread_local std::vector<std::function<int(char *, const char *)>> _scope_stack;
 
 struct scope_info_func_obj {
 	scope_info_func_obj(std::function<int(char *, const char *)> func)
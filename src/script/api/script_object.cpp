@@ -39,7 +39,7 @@ static ScriptStorage *GetStorage()
 }
 
 
-/* static */ ScriptInstance *ScriptObject::ActiveInstance::active = nullptr;
+/* static */ thread_local ScriptInstance *ScriptObject::ActiveInstance::active = nullptr;
 
 ScriptObject::ActiveInstance::ActiveInstance(ScriptInstance *instance) : alc_scope(instance->engine)
 {
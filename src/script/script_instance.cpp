@@ -46,6 +46,8 @@ ScriptStorage::~ScriptStorage()
  */
 static void PrintFunc(bool error_msg, const SQChar *message)
 {
+	ScriptGameStateScope game_state_scope;
+
 	/* Convert to OpenTTD internal capable string */
 	ScriptController::Print(error_msg, message);
 }
@@ -241,6 +243,8 @@ void ScriptInstance::GameLoop()
 	this->callback = nullptr;
 
 	if (!this->is_started) {
+		/* When scripts run in parallel, the constructor, Load and Start run with the game state lock held
+		 * for their whole duration, so these do not run in parallel with other scripts. */
 		try {
 			ScriptObject::SetAllowDoCommand(false);
 			/* Run the constructor if it exists. Don't allow any DoCommands in it. */
@@ -279,7 +283,13 @@ void ScriptInstance::GameLoop()
 
 	/* Continue the VM */
 	try {
-		if (!this->engine->Resume(this->GetMaxOpsTillSuspend())) this->Died();
+		bool running;
+		{
+			/* Only Squirrel code runs here, the script API takes the game state lock itself when scripts run in parallel */
+			ScriptGameStateReleaseScope game_state_release;
+			running = this->engine->Resume(this->GetMaxOpsTillSuspend());
+		}
+		if (!running) this->Died();
 	} catch (Script_Suspend &e) {
 		this->suspend  = e.GetSuspendTime();
 		this->callback = e.GetSuspendCallback();
@@ -14,13 +14,19 @@
 #include "../string_func.h"
 #include "script_fatalerror.hpp"
 #include "../settings_type.h"
+#include "../company_func.h"
 #include <sqstdaux.h>
 #include <../squirrel/sqpcheader.h>
 #include <../squirrel/sqvm.h>
 #include "../core/alloc_func.hpp"
 
 #include <stdarg.h>
+#include <chrono>
 #include <map>
+#include <mutex>
+#if defined(__MINGW32__)
+#include "../3rdparty/mingw-std-threads/mingw.mutex.h"
+#endif
 
 /**
  * In the memory allocator for Squirrel we want to directly use malloc/realloc, so when the OS
@@ -190,7 +196,40 @@ struct ScriptAllocator {
  */
 #include "../safeguards.h"
 
-ScriptAllocator *_squirrel_allocator = nullptr;
+thread_local ScriptAllocator *_squirrel_allocator = nullptr;
+
+thread_local ScriptParallelThreadState *_script_parallel_thread = nullptr;
+
+/** Lock serialising the access to the game state of scripts running in parallel. */
+static std::mutex _script_game_state_mutex;
+
+/**
+ * Take the game state lock for the script running in parallel on the current thread,
+ * and make its company the current company.
+ */
+void ScriptLockGameState()
+{
+	ScriptParallelThreadState *state = _script_parallel_thread;
+	assert(state != nullptr && !state->locked);
+	if (!_script_game_state_mutex.try_lock()) {
+		auto start = std::chrono::steady_clock::now();
+		_script_game_state_mutex.lock();
+		state->lock_wait_us += (uint64)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+	state->locked = true;
+	_current_company = state->company;
+}
+
+/**
+ * Release the game state lock of the script running in parallel on the current thread.
+ */
+void ScriptUnlockGameState()
+{
+	ScriptParallelThreadState *state = _script_parallel_thread;
+	assert(state != nullptr && state->locked);
+	state->locked = false;
+	_script_game_state_mutex.unlock();
+}
 
 /* See 3rdparty/squirrel/squirrel/sqmem.cpp for the default allocator implementation, which this overrides */
 #ifndef SQUIRREL_DEFAULT_ALLOCATOR
@@ -11,6 +11,8 @@
 #define SQUIRREL_HPP
 
 #include <squirrel.h>
+#include "../company_type.h"
+#include "../worker_thread.h"
 
 /** The type of script we're working with, i.e. for who is it? */
 enum class ScriptType {
@@ -285,7 +287,7 @@ public:
 };
 
 
-extern ScriptAllocator *_squirrel_allocator;
+extern thread_local ScriptAllocator *_squirrel_allocator;
 
 class ScriptAllocatorScope {
 	ScriptAllocator *old_allocator;
@@ -304,4 +306,97 @@ public:
 	}
 };
 
+/** State of a thread which runs a script in parallel with other scripts, see ScriptParallelScope. */
+struct ScriptParallelThreadState {
+	CompanyID company;        ///< Company of the script, this is the current company whenever the script accesses the game state.
+	bool locked = false;      ///< Whether this thread holds the game state lock.
+	uint64 lock_wait_us = 0;  ///< Time spent waiting for the game state lock, in microseconds.
+};
+
+extern thread_local ScriptParallelThreadState *_script_parallel_thread;
+
+void ScriptLockGameState();
+void ScriptUnlockGameState();
+
+/**
+ * Scope in which the current thread runs a script in parallel with scripts on other threads.
+ * The Squirrel code of the scripts runs concurrently, but everything which accesses the game state,
+ * i.e. the script API, print functions and destructors of API objects, is serialised by the game state lock.
+ * The lock is held for the whole scope, except in a ScriptGameStateReleaseScope.
+ * Waiting for a worker thread pool could run another script on the same thread while the lock is held,
+ * so tasks enqueued on worker thread pools within this scope are run immediately, see WorkerThreadPoolInlineScope.
+ */
+class ScriptParallelScope {
+	WorkerThreadPoolInlineScope run_inline;
+	ScriptParallelThreadState state;
+
+public:
+	ScriptParallelScope(CompanyID company)
+	{
+		assert(_script_parallel_thread == nullptr);
+		this->state.company = company;
+		_script_parallel_thread = &this->state;
+		ScriptLockGameState();
+	}
+
+	~ScriptParallelScope()
+	{
+		ScriptUnlockGameState();
+		_script_parallel_thread = nullptr;
+	}
+
+	/**
+	 * Get the time spent waiting for other scripts so far.
+	 * @return Time in microseconds.
+	 */
+	uint64 GetLockWaitTime() const
+	{
+		return this->state.lock_wait_us;
+	}
+};
+
+/**
+ * Scope in which a script accesses the game state.
+ * When the script runs in parallel with other scripts, this holds the game state lock, otherwise this does nothing.
+ */
+class ScriptGameStateScope {
+	bool locked = false;
+
+public:
+	ScriptGameStateScope()
+	{
+		if (_script_parallel_thread != nullptr && !_script_parallel_thread->locked) {
+			ScriptLockGameState();
+			this->locked = true;
+		}
+	}
+
+	~ScriptGameStateScope()
+	{
+		if (this->locked) ScriptUnlockGameState();
+	}
+};
+
+/**
+ * Scope in which a script only runs Squirrel code, without accessing the game state.
+ * When the script runs in parallel with other scripts, this releases the game state lock, otherwise this does nothing.
+ */
+class ScriptGameStateReleaseScope {
+	bool released = false;
+
+public:
+	ScriptGameStateReleaseScope()
+	{
+		if (_script_parallel_thread != nullptr && _script_parallel_thread->locked) {
+			ScriptUnlockGameState();
+			this->released = true;
+		}
+	}
+
+	~ScriptGameStateReleaseScope()
+	{
+		if (this->released) ScriptLockGameState();
+	}
+};
+
 #endif /* SQUIRREL_HPP */
@@ -199,6 +199,9 @@ namespace SQConvert {
 	template <typename Tcls, typename Tmethod, ScriptType Ttype>
 	inline SQInteger DefSQNonStaticCallback(HSQUIRRELVM vm)
 	{
+		/* All script API calls may access the game state, this serialises them when scripts run in parallel */
+		ScriptGameStateScope game_state_scope;
+
 		/* Find the amount of params we got */
 		int nparam = sq_gettop(vm);
 		SQUserPointer ptr = nullptr;
@@ -241,6 +244,8 @@ namespace SQConvert {
 	template <typename Tcls, typename Tmethod, ScriptType Ttype>
 	inline SQInteger DefSQAdvancedNonStaticCallback(HSQUIRRELVM vm)
 	{
+		ScriptGameStateScope game_state_scope;
+
 		/* Find the amount of params we got */
 		int nparam = sq_gettop(vm);
 		SQUserPointer ptr = nullptr;
@@ -279,6 +284,8 @@ namespace SQConvert {
 	template <typename Tcls, typename Tmethod>
 	inline SQInteger DefSQStaticCallback(HSQUIRRELVM vm)
 	{
+		ScriptGameStateScope game_state_scope;
+
 		/* Find the amount of params we got */
 		int nparam = sq_gettop(vm);
 		SQUserPointer ptr = nullptr;
@@ -303,6 +310,8 @@ namespace SQConvert {
 	template <typename Tcls, typename Tmethod>
 	inline SQInteger DefSQAdvancedStaticCallback(HSQUIRRELVM vm)
 	{
+		ScriptGameStateScope game_state_scope;
+
 		/* Find the amount of params we got */
 		int nparam = sq_gettop(vm);
 		SQUserPointer ptr = nullptr;
@@ -323,6 +332,8 @@ namespace SQConvert {
 	template <typename Tcls>
 	static SQInteger DefSQDestructorCallback(SQUserPointer p, SQInteger size)
 	{
+		ScriptGameStateScope game_state_scope;
+
 		/* Remove the real instance too */
 		if (p != nullptr) ((Tcls *)p)->Release();
 		return 0;
@@ -336,6 +347,8 @@ namespace SQConvert {
 	template <typename Tcls, typename Tmethod, int Tnparam>
 	inline SQInteger DefSQConstructorCallback(HSQUIRRELVM vm)
 	{
+		ScriptGameStateScope game_state_scope;
+
 		try {
 			/* Create the real instance */
 			Tcls *instance = HelperT<Tmethod>::SQConstruct((Tcls *)nullptr, (Tmethod)nullptr, vm);
@@ -355,6 +368,8 @@ namespace SQConvert {
 	template <typename Tcls>
 	inline SQInteger DefSQAdvancedConstructorCallback(HSQUIRRELVM vm)
 	{
+		ScriptGameStateScope game_state_scope;
+
 		try {
 			/* Find the amount of params we got */
 			int nparam = sq_gettop(vm);
@@ -41,6 +41,9 @@ SQInteger SquirrelStd::max(HSQUIRRELVM vm)
 
 SQInteger SquirrelStd::require(HSQUIRRELVM vm)
 {
+	/* This reads and compiles files, which must not happen in parallel with other scripts */
+	ScriptGameStateScope game_state_scope;
+
 	SQInteger top = sq_gettop(vm);
 	const SQChar *filename;
 
@@ -2444,6 +2444,7 @@ static SettingsContainer &GetSettingsTree()
 			environment->Add(new SettingEntry("station.cargo_class_rating_wait_time"));
 			environment->Add(new SettingEntry("station.station_size_rating_cargo_amount"));
 			environment->Add(new SettingEntry("economy.tick_rate"));
+			environment->Add(new SettingEntry("economy.parallel_clear_tile_loop"));
 		}
 
 		SettingsPage *ai = main->Add(new SettingsPage(STR_CONFIG_SETTING_AI));
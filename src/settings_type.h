@@ -374,6 +374,9 @@ struct NetworkSettings {
 	uint16      max_password_time;                        ///< maximum amount of time, in game ticks, a client may take to enter the password
 	uint16      max_lag_time;                             ///< maximum amount of time, in game ticks, a client may be lagging behind the server
 	bool        pause_on_join;                            ///< pause the game when people join
+	bool        shared_map_download;                      ///< send the map to joining clients from a savegame which is shared between them
+	uint16      shared_map_download_max_age;              ///< maximum age, in game ticks, of a shared savegame for it to be sent to more clients
+	bool        parallel_ai_scripts;                      ///< run the scripts of AI companies in parallel on worker threads
 	uint16      server_port;                              ///< port the server listens on
 	uint16      server_admin_port;                        ///< port the server listens on for the admin network
 	bool        server_admin_chat;                        ///< allow private chat for the server to be distributed to the admin network
@@ -721,6 +724,7 @@ struct EconomySettings {
 	bool disable_inflation_newgrf_flag;      ///< Disable NewGRF inflation flag
 	CargoPaymentAlgorithm payment_algorithm; ///< Cargo payment algorithm
 	TickRateMode tick_rate;                  ///< Tick rate mode
+	bool parallel_clear_tile_loop;           ///< Run the tile loop of clear tiles on worker threads
 };
 
 struct LinkGraphSettings {
@@ -26,6 +26,8 @@
 #include "core/checksum_func.hpp"
 #include "core/hash_func.hpp"
 #include "pathfinder/follow_track.hpp"
+#include "debug_settings.h"
+#include "3rdparty/robin_hood/robin_hood.h"
 
 #include "safeguards.h"
 
@@ -233,6 +235,8 @@ static Vehicle *TrainInWormholeTileEnum(Vehicle *v, void *data)
 	return v;
 }
 
+static void RecordSignalSegmentGlobsetRemove(TileIndex tile, DiagDirection dir);
+
 /**
  * Perform some operations before adding data into Todo set
  * The new and reverse direction is removed from _globset, because we are sure
@@ -248,6 +252,8 @@ static Vehicle *TrainInWormholeTileEnum(Vehicle *v, void *data)
  */
 static inline bool CheckAddToTodoSet(TileIndex t1, DiagDirection d1, TileIndex t2, DiagDirection d2)
 {
+	RecordSignalSegmentGlobsetRemove(t1, d1);
+	RecordSignalSegmentGlobsetRemove(t2, d2);
 	_globset.Remove(t1, d1); // it can be in Global but not in Todo
 	_globset.Remove(t2, d2); // remove in all cases
 
@@ -305,6 +311,210 @@ struct SigInfo {
 	Trackdir out_signal_trackdir;
 };
 
+/**
+ * Type of a step of a signal segment exploration, which depends on more than the track layout.
+ * The sequence of these steps for a segment can be cached and replayed instead of flood-filling
+ * the segment again, until the track layout changes, see ExploreSegmentCached.
+ */
+enum SignalSegmentOpType : uint8 {
+	SSOT_TRAIN_ON_TILE,       ///< Look for a train on the tile, which is not in a depot.
+	SSOT_TRAIN_ON_TRACK_BITS, ///< Look for a train on the given track bits of the tile.
+	SSOT_DEPOT,               ///< Depot tile: PBS with realistic braking, look for a train.
+	SSOT_CROSSING,            ///< Level crossing tile: look for a train, PBS with safer crossings.
+	SSOT_JUNCTION,            ///< Junction found.
+	SSOT_REVERSE_SIGNAL,      ///< Signal against the direction of exploration.
+	SSOT_FORWARD_SIGNAL,      ///< Signal along the direction of exploration.
+	SSOT_TB_FROM_WORMHOLE,    ///< Signalled tunnel/bridge end, entered from the wormhole.
+	SSOT_TB_ACROSS,           ///< Signalled tunnel/bridge end, entered across the tunnel/bridge end.
+	SSOT_GLOBSET_REMOVE,      ///< Remove an item from _globset.
+};
+
+/** Step of a signal segment exploration. */
+struct SignalSegmentOp {
+	TileIndex tile;          ///< Tile of the step.
+	SignalSegmentOpType type;
+	uint8 data;              ///< TrackBits, Trackdir or DiagDirection, depending on type.
+
+	bool operator==(const SignalSegmentOp &other) const
+	{
+		return this->tile == other.tile && this->type == other.type && this->data == other.data;
+	}
+};
+
+/** Maximum number of cached signal segments, the cache is emptied when this is reached. */
+static const size_t SIGNAL_SEGMENT_CACHE_MAX_ENTRIES = 1 << 16;
+
+/** Cached exploration of a signal segment. */
+struct SignalSegmentCacheEntry {
+	std::vector<SignalSegmentOp> ops; ///< Exploration steps.
+	std::vector<uint> train_buckets;  ///< Train tile hash buckets of the tiles which the steps look for trains on, without duplicates.
+	uint occupied_train_buckets;      ///< Number of train_buckets which currently contain any train.
+};
+
+/** Cached signal segments, by key from GetSignalSegmentCacheKey. */
+static robin_hood::unordered_flat_map<uint64, SignalSegmentCacheEntry> _signal_segment_cache;
+/** Keys of the cached signal segments which look for trains in each train tile hash bucket. */
+static robin_hood::unordered_flat_map<uint, std::vector<uint64>> _signal_segment_train_bucket_index;
+/** Exploration steps being recorded by the current ExploreSegment call, if any. */
+static std::vector<SignalSegmentOp> *_signal_segment_recording = nullptr;
+/** Number of active SignalSegmentCacheSuspender instances. */
+static uint _signal_segment_cache_suspended = 0;
+/** Incremented when the track layout changes, see NotifySignalSegmentLayoutChanged. */
+static uint32 _signal_layout_generation = 0;
+/** Value of _signal_layout_generation when the cached segments were explored. */
+static uint32 _signal_segment_cache_generation = 0;
+
+/** Statistics of the signal segment cache. */
+static struct {
+	uint64 explorations;           ///< Segments which were explored.
+	uint64 replays;                ///< Segments which were replayed from the cache.
+	uint64 replays_without_trains; ///< Replayed segments without any train in their train tile hash buckets, of which the train checks were skipped.
+} _signal_segment_cache_stats;
+
+static void RecordSignalSegmentGlobsetRemove(TileIndex tile, DiagDirection dir)
+{
+	if (_signal_segment_recording != nullptr) _signal_segment_recording->push_back({ tile, SSOT_GLOBSET_REMOVE, (uint8)dir });
+}
+
+/**
+ * Apply one step of a signal segment exploration.
+ * @param op step to apply
+ * @param info segment state to update
+ * @param check_trains false if it is known that there is no train on any tile the step looks for trains on
+ * @return false if a buffer was full, and the exploration has to be stopped
+ */
+static bool ApplySignalSegmentOp(const SignalSegmentOp &op, SigInfo &info, bool check_trains)
+{
+	const TileIndex tile = op.tile;
+
+	/* Whether to look for trains, no train is found when it is known that there are none. */
+	const bool look_for_train = check_trains && !(info.flags & SF_TRAIN);
+
+	switch (op.type) {
+		case SSOT_TRAIN_ON_TILE:
+			if (look_for_train && HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum)) info.flags |= SF_TRAIN;
+			break;
+
+		case SSOT_TRAIN_ON_TRACK_BITS:
+			if (look_for_train && EnsureNoTrainOnTrackBits(tile, (TrackBits)op.data).Failed()) info.flags |= SF_TRAIN;
+			break;
+
+		case SSOT_DEPOT:
+			if (_settings_game.vehicle.train_braking_model == TBM_REALISTIC) info.flags |= SF_PBS;
+			if (look_for_train && HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum)) info.flags |= SF_TRAIN;
+			break;
+
+		case SSOT_CROSSING:
+			if (look_for_train && HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum)) info.flags |= SF_TRAIN;
+			if (_settings_game.vehicle.safer_crossings) info.flags |= SF_PBS;
+			break;
+
+		case SSOT_JUNCTION:
+			info.flags |= SF_JUNCTION;
+			break;
+
+		case SSOT_REVERSE_SIGNAL: {
+			const Trackdir reversedir = (Trackdir)op.data;
+			const Track track = TrackdirToTrack(reversedir);
+			if (IsPbsSignalNonExtended(GetSignalType(tile, track))) {
+				info.flags |= SF_PBS;
+				if (_extra_aspects > 0 && GetSignalStateByTrackdir(tile, reversedir) == SIGNAL_STATE_GREEN && !IsRailSpecialSignalAspect(tile, track)) {
+					_tbpset.Add(tile, reversedir);
+				}
+			} else if (!_tbuset.Add(tile, reversedir)) {
+				info.flags |= SF_FULL;
+				return false;
+			}
+			break;
+		}
+
+		case SSOT_FORWARD_SIGNAL: {
+			const Trackdir trackdir = (Trackdir)op.data;
+			const Track track = TrackdirToTrack(trackdir);
+			const SignalType sig = GetSignalType(tile, track);
+			if (!IsOnewaySignal(sig)) info.flags |= SF_PBS;
+			if (_extra_aspects > 0) {
+				info.out_signal_tile = tile;
+				info.out_signal_trackdir = trackdir;
+				if (_settings_game.vehicle.train_braking_model == TBM_REALISTIC && GetSignalAlwaysReserveThrough(tile, track) &&
+						GetSignalStateByTrackdir(tile, trackdir) == SIGNAL_STATE_RED) {
+					info.flags |= SF_PBS;
+				}
+			}
+
+			/* if it is a presignal EXIT in OUR direction, count it */
+			if (IsExitSignal(sig)) { // found presignal exit
+				info.num_exits++;
+				if (GetSignalStateByTrackdir(tile, trackdir) == SIGNAL_STATE_GREEN) { // found green presignal exit
+					info.num_green++;
+				}
+			}
+			break;
+		}
+
+		case SSOT_TB_FROM_WORMHOLE:
+			if (look_for_train && IsTunnelBridgeSignalSimulationExit(tile)) { // tunnel entrance is ignored
+				if (HasVehicleOnPos(GetOtherTunnelBridgeEnd(tile), VEH_TRAIN, reinterpret_cast<void *>((uintptr_t)tile), &TrainInWormholeTileEnum)) info.flags |= SF_TRAIN;
+				if (!(info.flags & SF_TRAIN) && HasVehicleOnPos(tile, VEH_TRAIN, reinterpret_cast<void *>((uintptr_t)tile), &TrainInWormholeTileEnum)) info.flags |= SF_TRAIN;
+			}
+			if (IsTunnelBridgeSignalSimulationExit(tile) && !_tbuset.Add(tile, INVALID_TRACKDIR)) {
+				info.flags |= SF_FULL;
+				return false;
+			}
+			if (_extra_aspects > 0 && IsTunnelBridgeSignalSimulationEntrance(tile)) {
+				info.out_signal_tile = tile;
+				info.out_signal_trackdir = GetTunnelBridgeEntranceTrackdir(tile, GetTunnelBridgeDirection(tile));
+			}
+			break;
+
+		case SSOT_TB_ACROSS:
+			if (IsTunnelBridgeSignalSimulationExit(tile)) {
+				if (IsTunnelBridgePBS(tile)) {
+					info.flags |= SF_PBS;
+					if (_extra_aspects > 0 && GetTunnelBridgeExitSignalState(tile) == SIGNAL_STATE_GREEN) {
+						Trackdir exit_td = GetTunnelBridgeExitTrackdir(tile, GetTunnelBridgeDirection(tile));
+						_tbpset.Add(tile, exit_td);
+					}
+				} else if (!_tbuset.Add(tile, INVALID_TRACKDIR)) {
+					info.flags |= SF_FULL;
+					return false;
+				}
+			}
+			if (_extra_aspects > 0 && IsTunnelBridgeSignalSimulationEntrance(tile)) {
+				info.out_signal_tile = tile;
+				info.out_signal_trackdir = GetTunnelBridgeEntranceTrackdir(tile, GetTunnelBridgeDirection(tile));
+			}
+			if (look_for_train) {
+				if (HasVehicleOnPos(tile, VEH_TRAIN, reinterpret_cast<void *>((uintptr_t)tile), &TrainInWormholeTileEnum)) info.flags |= SF_TRAIN;
+				if (!(info.flags & SF_TRAIN) && IsTunnelBridgeSignalSimulationExit(tile)) {
+					if (HasVehicleOnPos(GetOtherTunnelBridgeEnd(tile), VEH_TRAIN, reinterpret_cast<void *>((uintptr_t)tile), &TrainInWormholeTileEnum)) info.flags |= SF_TRAIN;
+				}
+			}
+			break;
+
+		case SSOT_GLOBSET_REMOVE:
+			_globset.Remove(tile, (DiagDirection)op.data);
+			break;
+	}
+
+	return true;
+}
+
+/**
+ * Apply one step of a signal segment exploration, and record it if the exploration is being recorded.
+ * @param info segment state to update
+ * @param type type of the step
+ * @param tile tile of the step
+ * @param data TrackBits, Trackdir or DiagDirection, depending on type
+ * @return false if a buffer was full, and the exploration has to be stopped
+ */
+static inline bool ExploreSegmentOp(SigInfo &info, SignalSegmentOpType type, TileIndex tile, uint8 data)
+{
+	SignalSegmentOp op{ tile, type, data };
+	if (_signal_segment_recording != nullptr) _signal_segment_recording->push_back(op);
+	return ApplySignalSegmentOp(op, info, true);
+}
+
 /**
  * Search signal block
  *
@@ -328,15 +538,13 @@ static SigInfo ExploreSegment(Owner owner)
 
 				if (IsRailDepot(tile)) {
 					if (enterdir == INVALID_DIAGDIR) { // from 'inside' - train just entered or left the depot
-						if (_settings_game.vehicle.train_braking_model == TBM_REALISTIC) info.flags |= SF_PBS;
-						if (!(info.flags & SF_TRAIN) && HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum)) info.flags |= SF_TRAIN;
+						ExploreSegmentOp(info, SSOT_DEPOT, tile, 0);
 						exitdir = GetRailDepotDirection(tile);
 						tile += TileOffsByDiagDir(exitdir);
 						enterdir = ReverseDiagDir(exitdir);
 						break;
 					} else if (enterdir == GetRailDepotDirection(tile)) { // entered a depot
-						if (_settings_game.vehicle.train_braking_model == TBM_REALISTIC) info.flags |= SF_PBS;
-						if (!(info.flags & SF_TRAIN) && HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum)) info.flags |= SF_TRAIN;
+						ExploreSegmentOp(info, SSOT_DEPOT, tile, 0);
 						continue;
 					} else {
 						continue;
@@ -350,57 +558,32 @@ static SigInfo ExploreSegment(Owner owner)
 				if (tracks == TRACK_BIT_HORZ || tracks == TRACK_BIT_VERT) { // there is exactly one incidating track, no need to check
 					tracks = tracks_masked;
 					/* If no train detected yet, and there is not no train -> there is a train -> set the flag */
-					if (!(info.flags & SF_TRAIN) && EnsureNoTrainOnTrackBits(tile, tracks).Failed()) info.flags |= SF_TRAIN;
+					ExploreSegmentOp(info, SSOT_TRAIN_ON_TRACK_BITS, tile, tracks);
 				} else {
 					if (tracks_masked == TRACK_BIT_NONE) continue; // no incidating track
-					if (!(info.flags & SF_TRAIN) && HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum)) info.flags |= SF_TRAIN;
+					ExploreSegmentOp(info, SSOT_TRAIN_ON_TILE, tile, 0);
 				}
 
 				if (HasSignals(tile)) { // there is exactly one track - not zero, because there is exit from this tile
 					Track track = TrackBitsToTrack(tracks_masked); // mask TRACK_BIT_X and Y too
 					if (HasSignalOnTrack(tile, track)) { // now check whole track, not trackdir
-						SignalType sig = GetSignalType(tile, track);
 						Trackdir trackdir = (Trackdir)FindFirstBit((tracks * 0x101) & _enterdir_to_trackdirbits[enterdir]);
 						Trackdir reversedir = ReverseTrackdir(trackdir);
 						/* add (tile, reversetrackdir) to 'to-be-updated' set when there is
 						 * ANY conventional signal in REVERSE direction
 						 * (if it is a presignal EXIT and it changes, it will be added to 'to-be-done' set later) */
 						if (HasSignalOnTrackdir(tile, reversedir)) {
-							if (IsPbsSignalNonExtended(sig)) {
-								info.flags |= SF_PBS;
-								if (_extra_aspects > 0 && GetSignalStateByTrackdir(tile, reversedir) == SIGNAL_STATE_GREEN && !IsRailSpecialSignalAspect(tile, track)) {
-									_tbpset.Add(tile, reversedir);
-								}
-							} else if (!_tbuset.Add(tile, reversedir)) {
-								info.flags |= SF_FULL;
-								return info;
-							}
+							if (!ExploreSegmentOp(info, SSOT_REVERSE_SIGNAL, tile, reversedir)) return info;
 						}
 
 						if (HasSignalOnTrackdir(tile, trackdir)) {
-							if (!IsOnewaySignal(sig)) info.flags |= SF_PBS;
-							if (_extra_aspects > 0) {
-								info.out_signal_tile = tile;
-								info.out_signal_trackdir = trackdir;
-								if (_settings_game.vehicle.train_braking_model == TBM_REALISTIC && GetSignalAlwaysReserveThrough(tile, track) &&
-										GetSignalStateByTrackdir(tile, trackdir) == SIGNAL_STATE_RED) {
-									info.flags |= SF_PBS;
-								}
-							}
-
-							/* if it is a presignal EXIT in OUR direction, count it */
-							if (IsExitSignal(sig)) { // found presignal exit
-								info.num_exits++;
-								if (GetSignalStateByTrackdir(tile, trackdir) == SIGNAL_STATE_GREEN) { // found green presignal exit
-									info.num_green++;
-								}
-							}
+							ExploreSegmentOp(info, SSOT_FORWARD_SIGNAL, tile, trackdir);
 						}
 
 						continue;
 					}
 				} else if (!HasAtMostOneBit(tracks)) {
-					info.flags |= SF_JUNCTION;
+					ExploreSegmentOp(info, SSOT_JUNCTION, tile, 0);
 				}
 
 				for (DiagDirection dir = DIAGDIR_BEGIN; dir < DIAGDIR_END; dir++) { // test all possible exit directions
@@ -423,7 +606,7 @@ static SigInfo ExploreSegment(Owner owner)
 				if (DiagDirToAxis(enterdir) != GetRailStationAxis(tile)) continue; // different axis
 				if (IsStationTileBlocked(tile)) continue; // 'eye-candy' station tile
 
-				if (!(info.flags & SF_TRAIN) && HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum)) info.flags |= SF_TRAIN;
+				ExploreSegmentOp(info, SSOT_TRAIN_ON_TILE, tile, 0);
 				tile += TileOffsByDiagDir(exitdir);
 				break;
 
@@ -432,8 +615,7 @@ static SigInfo ExploreSegment(Owner owner)
 				if (!IsOneSignalBlock(owner, GetTileOwner(tile))) continue;
 				if (DiagDirToAxis(enterdir) == GetCrossingRoadAxis(tile)) continue; // different axis
 
-				if (!(info.flags & SF_TRAIN) && HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum)) info.flags |= SF_TRAIN;
-				if (_settings_game.vehicle.safer_crossings) info.flags |= SF_PBS;
+				ExploreSegmentOp(info, SSOT_CROSSING, tile, 0);
 				tile += TileOffsByDiagDir(exitdir);
 				break;
 
@@ -447,15 +629,15 @@ static SigInfo ExploreSegment(Owner owner)
 				TrackBits tracks = GetTunnelBridgeTrackBits(tile);
 				TrackBits across_tracks = GetAcrossTunnelBridgeTrackBits(tile);
 
-				auto check_train_present = [tile, tracks, across_tracks](DiagDirection enterdir) -> bool {
+				auto check_train_present = [&info, tile, tracks, across_tracks](DiagDirection enterdir) {
 					if (tracks == TRACK_BIT_HORZ || tracks == TRACK_BIT_VERT) {
 						if (_enterdir_to_trackbits[enterdir] & across_tracks) {
-							return EnsureNoTrainOnTrackBits(tile, TRACK_BIT_WORMHOLE | across_tracks).Failed();
+							ExploreSegmentOp(info, SSOT_TRAIN_ON_TRACK_BITS, tile, TRACK_BIT_WORMHOLE | across_tracks);
 						} else {
-							return EnsureNoTrainOnTrackBits(tile, tracks & (~across_tracks)).Failed();
+							ExploreSegmentOp(info, SSOT_TRAIN_ON_TRACK_BITS, tile, tracks & (~across_tracks));
 						}
 					} else {
-						return HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum);
+						ExploreSegmentOp(info, SSOT_TRAIN_ON_TILE, tile, 0);
 					}
 				};
 
@@ -465,18 +647,7 @@ static SigInfo ExploreSegment(Owner owner)
 				if (IsTunnelBridgeWithSignalSimulation(tile)) {
 					if (enterdir == INVALID_DIAGDIR) {
 						// incoming from the wormhole, onto signal
-						if (!(info.flags & SF_TRAIN) && IsTunnelBridgeSignalSimulationExit(tile)) { // tunnel entrance is ignored
-							if (HasVehicleOnPos(GetOtherTunnelBridgeEnd(tile), VEH_TRAIN, reinterpret_cast<void *>((uintptr_t)tile), &TrainInWormholeTileEnum)) info.flags |= SF_TRAIN;
-							if (!(info.flags & SF_TRAIN) && HasVehicleOnPos(tile, VEH_TRAIN, reinterpret_cast<void *>((uintptr_t)tile), &TrainInWormholeTileEnum)) info.flags |= SF_TRAIN;
-						}
-						if (IsTunnelBridgeSignalSimulationExit(tile) && !_tbuset.Add(tile, INVALID_TRACKDIR)) {
-							info.flags |= SF_FULL;
-							return info;
-						}
-						if (_extra_aspects > 0 && IsTunnelBridgeSignalSimulationEntrance(tile)) {
-							info.out_signal_tile = tile;
-							info.out_signal_trackdir = GetTunnelBridgeEntranceTrackdir(tile, tunnel_bridge_dir);
-						}
+						if (!ExploreSegmentOp(info, SSOT_TB_FROM_WORMHOLE, tile, 0)) return info;
 						Trackdir exit_track = GetTunnelBridgeExitTrackdir(tile, tunnel_bridge_dir);
 						exitdir = TrackdirToExitdir(exit_track);
 						enterdir = ReverseDiagDir(exitdir);
@@ -484,39 +655,18 @@ static SigInfo ExploreSegment(Owner owner)
 						break;
 					} else if (_enterdir_to_trackbits[enterdir] & GetAcrossTunnelBridgeTrackBits(tile)) {
 						// NOT incoming from the wormhole!
-						if (IsTunnelBridgeSignalSimulationExit(tile)) {
-							if (IsTunnelBridgePBS(tile)) {
-								info.flags |= SF_PBS;
-								if (_extra_aspects > 0 && GetTunnelBridgeExitSignalState(tile) == SIGNAL_STATE_GREEN) {
-									Trackdir exit_td = GetTunnelBridgeExitTrackdir(tile, tunnel_bridge_dir);
-									_tbpset.Add(tile, exit_td);
-								}
-							} else if (!_tbuset.Add(tile, INVALID_TRACKDIR)) {
-								info.flags |= SF_FULL;
-								return info;
-							}
-						}
-						if (_extra_aspects > 0 && IsTunnelBridgeSignalSimulationEntrance(tile)) {
-							info.out_signal_tile = tile;
-							info.out_signal_trackdir = GetTunnelBridgeEntranceTrackdir(tile, tunnel_bridge_dir);
-						}
-						if (!(info.flags & SF_TRAIN)) {
-							if (HasVehicleOnPos(tile, VEH_TRAIN, reinterpret_cast<void *>((uintptr_t)tile), &TrainInWormholeTileEnum)) info.flags |= SF_TRAIN;
-							if (!(info.flags & SF_TRAIN) && IsTunnelBridgeSignalSimulationExit(tile)) {
-								if (HasVehicleOnPos(GetOtherTunnelBridgeEnd(tile), VEH_TRAIN, reinterpret_cast<void *>((uintptr_t)tile), &TrainInWormholeTileEnum)) info.flags |= SF_TRAIN;
-							}
-						}
+						if (!ExploreSegmentOp(info, SSOT_TB_ACROSS, tile, 0)) return info;
 						continue;
 					}
 				} else if (!HasAtMostOneBit(tracks)) {
-					info.flags |= SF_JUNCTION;
+					ExploreSegmentOp(info, SSOT_JUNCTION, tile, 0);
 				}
 				if (enterdir == INVALID_DIAGDIR) { // incoming from the wormhole
-					if (!(info.flags & SF_TRAIN) && check_train_present(tunnel_bridge_dir)) info.flags |= SF_TRAIN;
+					check_train_present(tunnel_bridge_dir);
 					enterdir = tunnel_bridge_dir;
 				} else if (enterdir != tunnel_bridge_dir) { // NOT incoming from the wormhole!
 					if (tracks_masked == TRACK_BIT_NONE) continue; // no incidating track
-					if (!(info.flags & SF_TRAIN) && check_train_present(enterdir)) info.flags |= SF_TRAIN;
+					check_train_present(enterdir);
 				}
 				for (DiagDirection dir = DIAGDIR_BEGIN; dir < DIAGDIR_END; dir++) { // test all possible exit directions
 					if (dir != enterdir && (tracks & _enterdir_to_trackbits[dir])) { // any track incidating?
@@ -550,6 +700,110 @@ static SigInfo ExploreSegment(Owner owner)
 	return info;
 }
 
+/**
+ * Get the signal segment cache key of an exploration.
+ * @param tile tile of the _globset item the exploration starts from
+ * @param dir direction of the _globset item the exploration starts from
+ * @param owner owner whose signals are being updated
+ * @return cache key
+ */
+static inline uint64 GetSignalSegmentCacheKey(TileIndex tile, DiagDirection dir, Owner owner)
+{
+	return (uint64)tile | ((uint64)(uint8)dir << 32) | ((uint64)owner << 40) | ((uint64)_settings_game.economy.infrastructure_sharing[VEH_TRAIN] << 48);
+}
+
+/**
+ * Whether the signal segment cache may currently be used.
+ * @return true if the cache may be used
+ */
+static inline bool IsSignalSegmentCacheUsable()
+{
+	return _signal_segment_cache_suspended == 0 && !HasChickenBit(DCBF_NO_SIGNAL_SEGMENT_CACHE);
+}
+
+/**
+ * Get the train tile hash buckets of the tiles which the steps of a signal segment exploration look for trains on.
+ * @param ops steps of the exploration
+ * @param[out] buckets the buckets, without duplicates
+ */
+static void GetSignalSegmentTrainBuckets(const std::vector<SignalSegmentOp> &ops, std::vector<uint> &buckets)
+{
+	buckets.clear();
+	for (const SignalSegmentOp &op : ops) {
+		switch (op.type) {
+			case SSOT_TRAIN_ON_TILE:
+			case SSOT_TRAIN_ON_TRACK_BITS:
+			case SSOT_DEPOT:
+			case SSOT_CROSSING:
+				buckets.push_back(GetTrainTileHashBucket(op.tile));
+				break;
+
+			case SSOT_TB_FROM_WORMHOLE:
+			case SSOT_TB_ACROSS:
+				buckets.push_back(GetTrainTileHashBucket(op.tile));
+				buckets.push_back(GetTrainTileHashBucket(GetOtherTunnelBridgeEnd(op.tile)));
+				break;
+
+			default:
+				break;
+		}
+	}
+	std::sort(buckets.begin(), buckets.end());
+	buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+}
+
+/**
+ * Search signal block, using the signal segment cache if possible.
+ * _tbdset must already contain the start of the exploration.
+ *
+ * @param owner owner whose signals we are updating
+ * @param tile tile of the _globset item the exploration starts from
+ * @param dir direction of the _globset item the exploration starts from
+ * @return SigFlags
+ */
+static SigInfo ExploreSegmentCached(Owner owner, TileIndex tile, DiagDirection dir)
+{
+	if (!IsSignalSegmentCacheUsable()) return ExploreSegment(owner);
+
+	if (_signal_segment_cache_generation != _signal_layout_generation) {
+		ClearSignalSegmentCache();
+		_signal_segment_cache_generation = _signal_layout_generation;
+	}
+
+	const uint64 key = GetSignalSegmentCacheKey(tile, dir, owner);
+	auto iter = _signal_segment_cache.find(key);
+	if (iter != _signal_segment_cache.end()) {
+		_tbdset.Reset();
+		SigInfo info;
+		const bool check_trains = (iter->second.occupied_train_buckets != 0);
+		_signal_segment_cache_stats.replays++;
+		if (!check_trains) _signal_segment_cache_stats.replays_without_trains++;
+		for (const SignalSegmentOp &op : iter->second.ops) {
+			if (!ApplySignalSegmentOp(op, info, check_trains)) break;
+		}
+		return info;
+	}
+
+	SignalSegmentCacheEntry entry;
+	_signal_segment_recording = &entry.ops;
+	SigInfo info = ExploreSegment(owner);
+	_signal_segment_recording = nullptr;
+	_signal_segment_cache_stats.explorations++;
+
+	/* Explorations which overran a buffer are not cached, they are aborted anyway. */
+	if (!(info.flags & SF_FULL)) {
+		if (_signal_segment_cache.size() >= SIGNAL_SEGMENT_CACHE_MAX_ENTRIES) ClearSignalSegmentCache();
+		GetSignalSegmentTrainBuckets(entry.ops, entry.train_buckets);
+		entry.occupied_train_buckets = 0;
+		for (uint bucket : entry.train_buckets) {
+			if (IsTrainTileHashBucketOccupied(bucket)) entry.occupied_train_buckets++;
+			_signal_segment_train_bucket_index[bucket].push_back(key);
+		}
+		_signal_segment_cache[key] = std::move(entry);
+	}
+	return info;
+}
+
 static uint8 GetSignalledTunnelBridgeEntranceForwardAspect(TileIndex tile, TileIndex tile_exit)
 {
 	if (!IsTunnelBridgeSignalSimulationEntrance(tile)) return 0;
@@ -912,6 +1166,73 @@ static inline void ResetSets()
 }
 
 
+/**
+ * Add the start of the exploration of a signal segment to _tbdset.
+ *
+ * @param tile tile of the _globset item
+ * @param dir direction of the _globset item
+ * @return false if there is nothing to explore
+ */
+static bool AddSegmentStartToTodoSet(TileIndex tile, DiagDirection dir)
+{
+	/* After updating signal, data stored are always MP_RAILWAY with signals.
+	 * Other situations happen when data are from outside functions -
+	 * modification of railbits (including both rail building and removal),
+	 * train entering/leaving block, train leaving depot...
+	 */
+	switch (GetTileType(tile)) {
+		case MP_TUNNELBRIDGE: {
+			/* 'optimization assert' - do not try to update signals when it is not needed */
+			assert_tile(GetTunnelBridgeTransportType(tile) == TRANSPORT_RAIL, tile);
+			if (IsTunnel(tile)) assert(dir == INVALID_DIAGDIR || dir == ReverseDiagDir(GetTunnelBridgeDirection(tile)));
+			TrackBits across = GetAcrossTunnelBridgeTrackBits(tile);
+			if (dir == INVALID_DIAGDIR || _enterdir_to_trackbits[dir] & across) {
+				if (IsTunnelBridgeWithSignalSimulation(tile)) {
+					/* Don't worry about other side of tunnel. */
+					_tbdset.Add(tile, dir);
+				} else {
+					_tbdset.Add(tile, INVALID_DIAGDIR);  // we can safely start from wormhole centre
+					_tbdset.Add(GetOtherTunnelBridgeEnd(tile), INVALID_DIAGDIR);
+				}
+				break;
+			}
+		}
+			FALLTHROUGH;
+
+		case MP_RAILWAY:
+			if (IsRailDepotTile(tile)) {
+				/* 'optimization assert' do not try to update signals in other cases */
+				assert(dir == INVALID_DIAGDIR || dir == GetRailDepotDirection(tile));
+				_tbdset.Add(tile, INVALID_DIAGDIR); // start from depot inside
+				break;
+			}
+			FALLTHROUGH;
+
+		case MP_STATION:
+		case MP_ROAD:
+			if ((TrackdirBitsToTrackBits(GetTileTrackdirBits(tile, TRANSPORT_RAIL, 0)) & _enterdir_to_trackbits[dir]) != TRACK_BIT_NONE) {
+				/* only add to set when there is some 'interesting' track */
+				_tbdset.Add(tile, dir);
+				_tbdset.Add(tile + TileOffsByDiagDir(dir), ReverseDiagDir(dir));
+				break;
+			}
+			FALLTHROUGH;
+
+		default:
+			/* jump to next tile */
+			tile = tile + TileOffsByDiagDir(dir);
+			dir = ReverseDiagDir(dir);
+			if ((TrackdirBitsToTrackBits(GetTileTrackdirBits(tile, TRANSPORT_RAIL, 0)) & _enterdir_to_trackbits[dir]) != TRACK_BIT_NONE) {
+				_tbdset.Add(tile, dir);
+				break;
+			}
+			/* happens when removing a rail that wasn't connected at one or both sides */
+			return false;
+	}
+
+	return true;
+}
+
 /**
  * Updates blocks in _globset buffer
  *
@@ -934,65 +1255,12 @@ static SigSegState UpdateSignalsInBuffer(Owner owner)
 		assert(_tbuset.IsEmpty());
 		assert(_tbdset.IsEmpty());
 
-		/* After updating signal, data stored are always MP_RAILWAY with signals.
-		 * Other situations happen when data are from outside functions -
-		 * modification of railbits (including both rail building and removal),
-		 * train entering/leaving block, train leaving depot...
-		 */
-		switch (GetTileType(tile)) {
-			case MP_TUNNELBRIDGE: {
-				/* 'optimization assert' - do not try to update signals when it is not needed */
-				assert_tile(GetTunnelBridgeTransportType(tile) == TRANSPORT_RAIL, tile);
-				if (IsTunnel(tile)) assert(dir == INVALID_DIAGDIR || dir == ReverseDiagDir(GetTunnelBridgeDirection(tile)));
-				TrackBits across = GetAcrossTunnelBridgeTrackBits(tile);
-				if (dir == INVALID_DIAGDIR || _enterdir_to_trackbits[dir] & across) {
-					if (IsTunnelBridgeWithSignalSimulation(tile)) {
-						/* Don't worry about other side of tunnel. */
-						_tbdset.Add(tile, dir);
-					} else {
-						_tbdset.Add(tile, INVALID_DIAGDIR);  // we can safely start from wormhole centre
-						_tbdset.Add(GetOtherTunnelBridgeEnd(tile), INVALID_DIAGDIR);
-					}
-					break;
-				}
-			}
-				FALLTHROUGH;
-
-			case MP_RAILWAY:
-				if (IsRailDepotTile(tile)) {
-					/* 'optimization assert' do not try to update signals in other cases */
-					assert(dir == INVALID_DIAGDIR || dir == GetRailDepotDirection(tile));
-					_tbdset.Add(tile, INVALID_DIAGDIR); // start from depot inside
-					break;
-				}
-				FALLTHROUGH;
-
-			case MP_STATION:
-			case MP_ROAD:
-				if ((TrackdirBitsToTrackBits(GetTileTrackdirBits(tile, TRANSPORT_RAIL, 0)) & _enterdir_to_trackbits[dir]) != TRACK_BIT_NONE) {
-					/* only add to set when there is some 'interesting' track */
-					_tbdset.Add(tile, dir);
-					_tbdset.Add(tile + TileOffsByDiagDir(dir), ReverseDiagDir(dir));
-					break;
-				}
-				FALLTHROUGH;
-
-			default:
-				/* jump to next tile */
-				tile = tile + TileOffsByDiagDir(dir);
-				dir = ReverseDiagDir(dir);
-				if ((TrackdirBitsToTrackBits(GetTileTrackdirBits(tile, TRANSPORT_RAIL, 0)) & _enterdir_to_trackbits[dir]) != TRACK_BIT_NONE) {
-					_tbdset.Add(tile, dir);
-					break;
-				}
-				/* happens when removing a rail that wasn't connected at one or both sides */
-				continue; // continue the while() loop
-		}
+		if (!AddSegmentStartToTodoSet(tile, dir)) continue;
 
 		assert(!_tbdset.Overflowed()); // it really shouldn't overflow by these one or two items
 		assert(!_tbdset.IsEmpty()); // it wouldn't hurt anyone, but shouldn't happen too
 
-		SigInfo info = ExploreSegment(owner);
+		SigInfo info = ExploreSegmentCached(owner, tile, dir);
 
 		if (first) {
 			first = false;
@@ -1176,6 +1444,110 @@ void FreeSignalDependencies()
 	_signal_dependencies.clear();
 }
 
+/** Remove all cached signal segments. */
+void ClearSignalSegmentCache()
+{
+	_signal_segment_cache.clear();
+	_signal_segment_train_bucket_index.clear();
+}
+
+/**
+ * Update the train occupancy of the cached signal segments, when a train tile hash bucket becomes empty or gets its first train.
+ * Replays of segments without any train in their buckets skip looking for trains, as none can be found.
+ * @param bucket the train tile hash bucket
+ * @param occupied whether the bucket now contains any train
+ */
+void NotifySignalSegmentTrainBucketOccupancy(uint bucket, bool occupied)
+{
+	auto iter = _signal_segment_train_bucket_index.find(bucket);
+	if (iter == _signal_segment_train_bucket_index.end()) return;
+
+	for (uint64 key : iter->second) {
+		SignalSegmentCacheEntry &entry = _signal_segment_cache.find(key)->second;
+		if (occupied) {
+			entry.occupied_train_buckets++;
+		} else {
+			dbg_assert(entry.occupied_train_buckets > 0);
+			entry.occupied_train_buckets--;
+		}
+	}
+}
+
+void DumpSignalSegmentCacheStats(char *b, const char *last)
+{
+	size_t ops = 0;
+	size_t buckets = 0;
+	size_t occupied = 0;
+	for (const auto &it : _signal_segment_cache) {
+		ops += it.second.ops.size();
+		buckets += it.second.train_buckets.size();
+		if (it.second.occupied_train_buckets != 0) occupied++;
+	}
+	b += seprintf(b, last, "Signal segment cache: %u segments, %u steps, %u train tile hash buckets, %u segments with trains\n",
+			(uint)_signal_segment_cache.size(), (uint)ops, (uint)buckets, (uint)occupied);
+	b += seprintf(b, last, "  Explorations: " OTTD_PRINTF64U ", replays: " OTTD_PRINTF64U ", replays without trains: " OTTD_PRINTF64U "\n",
+			_signal_segment_cache_stats.explorations, _signal_segment_cache_stats.replays, _signal_segment_cache_stats.replays_without_trains);
+}
+
+SignalSegmentCacheSuspender::SignalSegmentCacheSuspender()
+{
+	_signal_segment_cache_suspended++;
+}
+
+SignalSegmentCacheSuspender::~SignalSegmentCacheSuspender()
+{
+	_signal_segment_cache_suspended--;
+}
+
+/**
+ * Invalidate the cached signal segments, because the track layout, signals or track ownership changed.
+ * The cache is emptied on its next use.
+ */
+void NotifySignalSegmentLayoutChanged()
+{
+	_signal_layout_generation++;
+}
+
+/**
+ * Check every cached signal segment against a fresh exploration of the segment.
+ * @return number of cached segments which do not match
+ */
+uint ValidateSignalSegmentCache()
+{
+	if (!_globset.IsEmpty()) return 0;
+	if (_signal_segment_cache_generation != _signal_layout_generation) return 0;
+
+	uint mismatches = 0;
+	for (const auto &it : _signal_segment_cache) {
+		const TileIndex tile = (TileIndex)GB(it.first, 0, 32);
+		const DiagDirection dir = (DiagDirection)GB(it.first, 32, 8);
+		const Owner owner = (Owner)GB(it.first, 40, 8);
+		if (HasBit(it.first, 48) != _settings_game.economy.infrastructure_sharing[VEH_TRAIN]) continue;
+
+		std::vector<SignalSegmentOp> ops;
+		if (AddSegmentStartToTodoSet(tile, dir)) {
+			_signal_segment_recording = &ops;
+			ExploreSegment(owner);
+			_signal_segment_recording = nullptr;
+		}
+		ResetSets();
+
+		if (ops != it.second.ops) {
+			mismatches++;
+			continue;
+		}
+
+		std::vector<uint> buckets;
+		GetSignalSegmentTrainBuckets(ops, buckets);
+		uint occupied = 0;
+		for (uint bucket : buckets) {
+			if (IsTrainTileHashBucketOccupied(bucket)) occupied++;
+		}
+		if (buckets != it.second.train_buckets || occupied != it.second.occupied_train_buckets) mismatches++;
+	}
+	return mismatches;
+}
+
 void UpdateSignalDependency(SignalReference sr)
 {
 	Trackdir td = TrackToTrackdir(sr.track);
@@ -179,6 +179,19 @@ void RemoveSignalDependency(SignalReference on, SignalReference dep);
 
 /// Frees signal dependencies (for newgame/load)
 void FreeSignalDependencies();
+void ClearSignalSegmentCache();
+void NotifySignalSegmentTrainBucketOccupancy(uint bucket, bool occupied);
+void NotifySignalSegmentLayoutChanged();
+uint ValidateSignalSegmentCache();
+
+/**
+ * Suspend use of the signal segment cache while the track layout may be inconsistent, e.g. while a command is executed.
+ * Changes of the track layout invalidate the cache through NotifySignalSegmentLayoutChanged.
+ */
+struct SignalSegmentCacheSuspender {
+	SignalSegmentCacheSuspender();
+	~SignalSegmentCacheSuspender();
+};
 
 SigSegState UpdateSignalsOnSegment(TileIndex tile, DiagDirection side, Owner owner);
 void SetSignalsOnBothDir(TileIndex tile, Track track, Owner owner);
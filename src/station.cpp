@@ -54,6 +54,8 @@ void RebuildStationKdtree()
 	_station_kdtree.Build(stids.begin(), stids.end());
 }
 
+StationCatchmentIndex _station_catchment_index;
+
 
 BaseStation::~BaseStation()
 {
@@ -95,6 +97,7 @@ Station::~Station()
 		for (CargoID c = 0; c < NUM_CARGO; c++) {
 			this->goods[c].cargo.OnCleanPool();
 		}
+		_station_catchment_index.Clear();
 		return;
 	}
 
@@ -138,6 +141,8 @@ Station::~Station()
 
 	/* Remove station from industries and towns that reference it. */
 	this->RemoveFromAllNearbyLists();
+	this->catchment_tiles.Reset();
+	this->UpdateCatchmentIndex();
 
 	/* Clear the persistent storage. */
 	delete this->airport.psa;
@@ -472,6 +477,143 @@ bool Station::CatchmentCoversTown(TownID t) const
 	return false;
 }
 
+/** Remove all stations from the index, and free its memory. */
+void StationCatchmentIndex::Clear()
+{
+	this->blocks.clear();
+	this->blocks.shrink_to_fit();
+}
+
+/**
+ * Update the catchment tiles of a station in the index.
+ * Only the blocks whose bitmask changed are updated.
+ * @param station The station.
+ * @param old_blocks The blocks of the station which are currently in the index, in block order.
+ * @param new_blocks The new blocks of the station, in block order.
+ */
+void StationCatchmentIndex::UpdateStation(StationID station, const std::vector<BlockMask> &old_blocks, const std::vector<BlockMask> &new_blocks)
+{
+	if (!new_blocks.empty()) {
+		const size_t block_count = MapSize() >> (BLOCK_BITS * 2);
+		if (this->blocks.size() != block_count) {
+			/* The index is empty when the map size changes, as all stations have been removed. */
+			this->blocks.clear();
+			this->blocks.resize(block_count);
+		}
+	}
+
+	auto station_entry = [&](uint32 block) {
+		std::vector<Entry> &entries = this->blocks[block];
+		return std::lower_bound(entries.begin(), entries.end(), station, [](const Entry &entry, StationID id) { return entry.station < id; });
+	};
+
+	auto old_it = old_blocks.begin();
+	auto new_it = new_blocks.begin();
+	while (old_it != old_blocks.end() || new_it != new_blocks.end()) {
+		if (new_it == new_blocks.end() || (old_it != old_blocks.end() && old_it->block < new_it->block)) {
+			/* Block is no longer in the catchment. */
+			auto it = station_entry(old_it->block);
+			dbg_assert(it != this->blocks[old_it->block].end() && it->station == station);
+			this->blocks[old_it->block].erase(it);
+			++old_it;
+		} else if (old_it == old_blocks.end() || new_it->block < old_it->block) {
+			/* Block is newly in the catchment. */
+			std::vector<Entry> &entries = this->blocks[new_it->block];
+			entries.insert(station_entry(new_it->block), { station, new_it->mask });
+			++new_it;
+		} else {
+			/* Block is still in the catchment, update the tiles if these changed. */
+			if (old_it->mask != new_it->mask) {
+				auto it = station_entry(new_it->block);
+				dbg_assert(it != this->blocks[new_it->block].end() && it->station == station);
+				it->mask = new_it->mask;
+			}
+			++old_it;
+			++new_it;
+		}
+	}
+}
+
+/**
+ * Get the number of station and block pairs in the index.
+ * @return The number of entries.
+ */
+size_t StationCatchmentIndex::GetEntryCount() const
+{
+	size_t entries = 0;
+	for (const std::vector<Entry> &block : this->blocks) {
+		entries += block.size();
+	}
+	return entries;
+}
+
+/**
+ * Get the memory used by the index.
+ * @return The memory usage, in bytes.
+ */
+size_t StationCatchmentIndex::GetMemoryUsage() const
+{
+	size_t bytes = this->blocks.capacity() * sizeof(std::vector<Entry>);
+	for (const std::vector<Entry> &block : this->blocks) {
+		bytes += block.capacity() * sizeof(Entry);
+	}
+	return bytes;
+}
+
+/**
+ * Update the station catchment index to the current catchment tiles of this station.
+ */
+void Station::UpdateCatchmentIndex()
+{
+	static std::vector<StationCatchmentIndex::BlockMask> new_blocks;
+	new_blocks.clear();
+
+	if (this->catchment_tiles.tile != INVALID_TILE) {
+		/* Collect the tiles of each block covered by the catchment area, in block order. */
+		const uint min_bx = TileX(this->catchment_tiles.tile) >> StationCatchmentIndex::BLOCK_BITS;
+		const uint min_by = TileY(this->catchment_tiles.tile) >> StationCatchmentIndex::BLOCK_BITS;
+		const uint max_bx = (TileX(this->catchment_tiles.tile) + this->catchment_tiles.w - 1) >> StationCatchmentIndex::BLOCK_BITS;
+		const uint max_by = (TileY(this->catchment_tiles.tile) + this->catchment_tiles.h - 1) >> StationCatchmentIndex::BLOCK_BITS;
+		const uint width = max_bx - min_bx + 1;
+
+		static std::vector<uint64> masks;
+		masks.assign(width * (max_by - min_by + 1), 0);
+
+		BitmapTileIterator it(this->catchment_tiles);
+		for (TileIndex tile = it; tile != INVALID_TILE; tile = ++it) {
+			const uint bx = (TileX(tile) >> StationCatchmentIndex::BLOCK_BITS) - min_bx;
+			const uint by = (TileY(tile) >> StationCatchmentIndex::BLOCK_BITS) - min_by;
+			SetBit(masks[(by * width) + bx], StationCatchmentIndex::GetTileBit(tile));
+		}
+
+		for (uint by = 0; by < max_by - min_by + 1; by++) {
+			for (uint bx = 0; bx < width; bx++) {
+				const uint64 mask = masks[(by * width) + bx];
+				if (mask == 0) continue;
+				const TileIndex block_tile = TileXY((min_bx + bx) << StationCatchmentIndex::BLOCK_BITS, (min_by + by) << StationCatchmentIndex::BLOCK_BITS);
+				new_blocks.push_back({ StationCatchmentIndex::GetBlock(block_tile), mask });
+			}
+		}
+	}
+
+	_station_catchment_index.UpdateStation(this->index, this->catchment_index_blocks, new_blocks);
+	this->catchment_index_blocks = new_blocks;
+}
+
+void DumpStationCatchmentIndexStats(char *b, const char *last)
+{
+	size_t used_blocks = 0;
+	for (const std::vector<StationCatchmentIndex::Entry> &block : _station_catchment_index.blocks) {
+		if (!block.empty()) used_blocks++;
+	}
+	const size_t entries = _station_catchment_index.GetEntryCount();
+	const size_t bytes = _station_catchment_index.GetMemoryUsage();
+	b += seprintf(b, last, "Station catchment index: %u entries, %u of %u blocks of %u x %u tiles used, %u stations\n",
+			(uint)entries, (uint)used_blocks, (uint)_station_catchment_index.blocks.size(),
+			1 << StationCatchmentIndex::BLOCK_BITS, 1 << StationCatchmentIndex::BLOCK_BITS, (uint)Station::GetNumItems());
+	b += seprintf(b, last, "  Memory: %u bytes, %.1f bytes/entry\n", (uint)bytes, entries > 0 ? (double)bytes / entries : 0.0);
+}
+
 /**
  * Recompute tiles covered in our catchment area.
  * This will additionally recompute nearby towns and industries.
@@ -484,6 +626,7 @@ void Station::RecomputeCatchment(bool no_clear_nearby_lists)
 
 	if (this->rect.IsEmpty()) {
 		this->catchment_tiles.Reset();
+		this->UpdateCatchmentIndex();
 		return;
 	}
 
@@ -510,6 +653,7 @@ void Station::RecomputeCatchment(bool no_clear_nearby_lists)
 			if (!IsTileType(tile, MP_STATION) || GetStationIndex(tile) != this->index) continue;
 			this->station_tiles++;
 		}
+		this->UpdateCatchmentIndex();
 		return;
 	}
 
@@ -550,6 +694,8 @@ void Station::RecomputeCatchment(bool no_clear_nearby_lists)
 			this->AddIndustryToDeliver(i, tile);
 		}
 	}
+
+	this->UpdateCatchmentIndex();
 }
 
 /**
@@ -799,6 +799,56 @@ struct IndustryCompare {
 
 typedef btree::btree_set<IndustryListEntry, IndustryCompare> IndustryList;
 
+/**
+ * Index of the catchment tiles of all stations.
+ * The map is divided into blocks of 8 x 8 tiles. For each block, the index holds the stations which have
+ * any tile of the block in their catchment, in order of station ID, together with a bitmask of those tiles.
+ */
+struct StationCatchmentIndex {
+	static const uint BLOCK_BITS = 3; ///< Log2 of the width and height of a block, in tiles.
+
+	/** Catchment tiles of a station within a block. */
+	struct Entry {
+		StationID station; ///< The station.
+		uint64 mask;       ///< Bitmask of the catchment tiles of the station within the block, see GetTileBit.
+
+		bool operator==(const Entry &other) const { return this->station == other.station && this->mask == other.mask; }
+	};
+
+	/** Catchment tiles of a station within a block, as stored for each station, see Station::catchment_index_blocks. */
+	struct BlockMask {
+		uint32 block; ///< Index of the block, see GetBlock.
+		uint64 mask;  ///< Bitmask of the catchment tiles of the station within the block, see GetTileBit.
+	};
+
+	std::vector<std::vector<Entry>> blocks; ///< Stations of each block, empty if there are no stations.
+
+	/**
+	 * Get the index of the block of a tile.
+	 * @param tile The tile.
+	 * @return The block index.
+	 */
+	static inline uint32 GetBlock(TileIndex tile)
+	{
+		return ((TileY(tile) >> BLOCK_BITS) << (MapLogX() - BLOCK_BITS)) | (TileX(tile) >> BLOCK_BITS);
+	}
+
+	/**
+	 * Get the bit of a tile in the bitmask of its block.
+	 * @param tile The tile.
+	 * @return The bit number.
+	 */
+	static inline uint GetTileBit(TileIndex tile)
+	{
+		return (GB(TileY(tile), 0, BLOCK_BITS) << BLOCK_BITS) | GB(TileX(tile), 0, BLOCK_BITS);
+	}
+
+	void Clear();
+	void UpdateStation(StationID station, const std::vector<BlockMask> &old_blocks, const std::vector<BlockMask> &new_blocks);
+	size_t GetEntryCount() const;
+	size_t GetMemoryUsage() const;
+};
+
 /** Station data structure */
 struct Station FINAL : SpecializedStation<Station, false> {
 public:
@@ -823,6 +873,7 @@ public:
 	uint16 extra_name_index; ///< Extra name index in use (or UINT16_MAX)
 
 	BitmapTileArea catchment_tiles; ///< NOSAVE: Set of individual tiles covered by catchment area
+	std::vector<StationCatchmentIndex::BlockMask> catchment_index_blocks; ///< NOSAVE: Blocks of catchment_tiles which are in the station catchment index, in block order
 	uint station_tiles;             ///< NOSAVE: Count of station tiles owned by this station
 
 	StationHadVehicleOfType had_vehicle_of_type;
@@ -860,6 +911,7 @@ public:
 	uint GetPlatformLength(TileIndex tile) const override;
 	void RecomputeCatchment(bool no_clear_nearby_lists = false);
 	static void RecomputeCatchmentForAll();
+	void UpdateCatchmentIndex();
 
 	uint GetCatchmentRadius() const;
 	Rect GetCatchmentRectUsingRadius(uint radius) const;
@@ -932,6 +984,28 @@ public:
 
 void RebuildStationKdtree();
 
+/** NOSAVE: Index of the catchment tiles of all stations. */
+extern StationCatchmentIndex _station_catchment_index;
+
+/**
+ * Call a function on all stations which have the given tile within their catchment, in order of station ID.
+ * This is equivalent to testing Station::TileIsInCatchment for every station.
+ * @tparam Func The type of function to call
+ * @param tile The tile to check
+ * @param func The function to call, must take one parameter: Station*
+ */
+template<typename Func>
+void ForAllStationsWithTileInCatchment(TileIndex tile, Func func)
+{
+	const uint32 block = StationCatchmentIndex::GetBlock(tile);
+	if (block >= _station_catchment_index.blocks.size()) return;
+
+	const uint bit = StationCatchmentIndex::GetTileBit(tile);
+	for (const StationCatchmentIndex::Entry &entry : _station_catchment_index.blocks[block]) {
+		if (HasBit(entry.mask, bit)) func(Station::Get(entry.station));
+	}
+}
+
 /**
  * Call a function on all stations that have any part of the requested area within their catchment.
  * @tparam Func The type of funcion to call
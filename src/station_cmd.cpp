@@ -763,6 +763,19 @@ static void UpdateStationSignCoord(BaseStation *st)
 	}
 }
 
+/**
+ * Initialise the rating update counter of a station which is in use.
+ * Ratings are then updated when (_tick_counter + index) % STATION_RATING_TICKS == 0, like the other periodic station updates,
+ * instead of in the tick the station was created, so that stations created in the same tick are not all updated together.
+ * The counter is stored in delete_ctr, which is only used as the delete countdown once the station is no longer in use,
+ * see DeleteStationIfEmpty.
+ * @param st The station.
+ */
+void InitStationRatingUpdateCounter(Station *st)
+{
+	st->delete_ctr = (_tick_counter + st->index) % STATION_RATING_TICKS;
+}
+
 /**
  * Common part of building various station parts and possibly attaching them to an existing one.
  * @param[in,out] st Station to attach to
@@ -791,6 +804,7 @@ static CommandCost BuildStationPart(Station **st, DoCommandFlag flags, bool reus
 		if (flags & DC_EXEC) {
 			*st = new Station(area.tile);
 			_station_kdtree.Insert((*st)->index);
+			InitStationRatingUpdateCounter(*st);
 
 			(*st)->town = ClosestTownFromTile(area.tile, UINT_MAX);
 			(*st)->string_id = GenerateStationName(*st, area.tile, name_class);
@@ -1662,10 +1676,10 @@ CommandCost CmdBuildRailStation(TileIndex tile_org, DoCommandFlag flags, uint32
 					TriggerStationAnimation(st, tile, SAT_BUILT);
 				}
 
+				YapfNotifyTrackLayoutChange(tile, track);
 				tile += tile_delta;
 			} while (--w);
 			AddTrackToSignalBuffer(tile_track, track, _current_company);
-			YapfNotifyTrackLayoutChange(tile_track, track);
 			tile_track += tile_delta ^ TileDiffXY(1, 1); // perpendicular to tile_delta
 		} while (--numtracks);
 
@@ -4388,6 +4402,9 @@ void RerouteCargo(Station *st, CargoID c, StationID avoid, StationID avoid2)
 	/* Reroute cargo in station. */
 	ge.cargo.Reroute(UINT_MAX, &ge.cargo, avoid, avoid2, &ge);
 
+	/* Rerouted packets are inserted without merging, merge these now. */
+	ge.cargo.Compact();
+
 	/* Reroute cargo staged to be transferred. */
 	for (Vehicle *v : st->loading_vehicles) {
 		for (Vehicle *u = v; u != nullptr; u = u->Next()) {
@@ -4413,6 +4430,9 @@ void RerouteCargoFromSource(Station *st, CargoID c, StationID source, StationID
 	/* Reroute cargo in station. */
 	ge.cargo.RerouteFromSource(UINT_MAX, &ge.cargo, source, avoid, avoid2, &ge);
 
+	/* Rerouted packets are inserted without merging, merge these now. */
+	ge.cargo.Compact();
+
 	/* Reroute cargo staged to be transferred. */
 	for (Vehicle *v : st->loading_vehicles) {
 		for (; v != nullptr; v = v->Next()) {
@@ -4593,7 +4613,7 @@ void IncreaseStats(Station *st, CargoID cargo, StationID next_station_id, uint c
 	}
 }
 
-/* called for every station each tick */
+/* called for every station each tick, delete_ctr is the rating update counter of stations which are in use */
 static void StationHandleSmallTick(BaseStation *st)
 {
 	if ((st->facilities & FACIL_WAYPOINT) != 0 || !st->IsInUse()) return;
@@ -4868,9 +4888,9 @@ CommandCost CmdSetStationCargoAllowedSupply(TileIndex tile, DoCommandFlag flags,
 
 static void AddNearbyStationsByCatchment(TileIndex tile, StationList *stations, StationList &nearby)
 {
-	for (Station *st : nearby) {
-		if (st->TileIsInCatchment(tile)) stations->insert(st);
-	}
+	ForAllStationsWithTileInCatchment(tile, [&](Station *st) {
+		if (nearby.find(st) != nearby.end()) stations->insert(st);
+	});
 }
 
 /**
@@ -5043,6 +5063,7 @@ void BuildOilRig(TileIndex tile)
 
 	Station *st = new Station(tile);
 	_station_kdtree.Insert(st->index);
+	InitStationRatingUpdateCounter(st);
 	st->town = ClosestTownFromTile(tile, UINT_MAX);
 
 	st->string_id = GenerateStationName(st, tile, STATIONNAMING_OILRIG);
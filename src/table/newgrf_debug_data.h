@@ -403,6 +403,13 @@ class NIHVehicle : public NIHelper {
 				seprintf(buffer, lastof(buffer), "    Callbacks: 0x%X, CB36 Properties: 0x" OTTD_PRINTFHEX64,
 						e->callbacks_used, e->cb36_properties_used);
 				output.print(buffer);
+				if (e->callbacks_used & SGCU_CB_RESULT_MEMOISABLE) {
+					const VehicleCallbackMemoStats &stats = _vehicle_callback_memo_stats;
+					const uint64 total = stats.hits + stats.misses;
+					seprintf(buffer, lastof(buffer), "    Callback memo: entries: %u, all vehicles: hits: " OTTD_PRINTF64U ", misses: " OTTD_PRINTF64U ", hit rate: %u%%",
+							(v->callback_memo.tick == _scaled_tick_counter) ? v->callback_memo.count : 0, stats.hits, stats.misses, total == 0 ? 0 : (uint)((stats.hits * 100) / total));
+					output.print(buffer);
+				}
 				uint64 cb36_properties = e->cb36_properties_used;
 				if (!e->sprite_group_cb36_properties_used.empty()) {
 					const SpriteGroup *root_spritegroup = nullptr;
@@ -14,6 +14,7 @@
 #include "genworld.h"
 #include "core/random_func.hpp"
 #include "landscape_type.h"
+#include "worker_thread.h"
 
 #include "safeguards.h"
 
@@ -454,79 +455,93 @@ static int *HeightMapMakeHistogram(Height h_min, Height h_max, int *hist_buf)
 	return hist;
 }
 
-/** Applies sine wave redistribution onto height map */
-static void HeightMapSineTransform(Height h_min, Height h_max)
+/**
+ * Apply the sine transform to a single height.
+ * @param h the height to transform
+ * @param h_min the minimum height of the height map
+ * @param h_max the maximum height of the height map
+ */
+static void HeightMapSineTransformHeight(Height &h, Height h_min, Height h_max)
 {
-	for (Height &h : _height_map.h) {
-		double fheight;
-
-		if (h < h_min) continue;
-
-		/* Transform height into 0..1 space */
-		fheight = (double)(h - h_min) / (double)(h_max - h_min);
-		/* Apply sine transform depending on landscape type */
-		switch (_settings_game.game_creation.landscape) {
-			case LT_TOYLAND:
-			case LT_TEMPERATE:
-				/* Move and scale 0..1 into -1..+1 */
-				fheight = 2 * fheight - 1;
-				/* Sine transform */
-				fheight = sin(fheight * M_PI_2);
-				/* Transform it back from -1..1 into 0..1 space */
-				fheight = 0.5 * (fheight + 1);
-				break;
-
-			case LT_ARCTIC:
-				{
-					/* Arctic terrain needs special height distribution.
-					 * Redistribute heights to have more tiles at highest (75%..100%) range */
-					double sine_upper_limit = 0.75;
-					double linear_compression = 2;
-					if (fheight >= sine_upper_limit) {
-						/* Over the limit we do linear compression up */
-						fheight = 1.0 - (1.0 - fheight) / linear_compression;
-					} else {
-						double m = 1.0 - (1.0 - sine_upper_limit) / linear_compression;
-						/* Get 0..sine_upper_limit into -1..1 */
-						fheight = 2.0 * fheight / sine_upper_limit - 1.0;
-						/* Sine wave transform */
-						fheight = sin(fheight * M_PI_2);
-						/* Get -1..1 back to 0..(1 - (1 - sine_upper_limit) / linear_compression) == 0.0..m */
-						fheight = 0.5 * (fheight + 1.0) * m;
-					}
+	double fheight;
+
+	if (h < h_min) return;
+
+	/* Transform height into 0..1 space */
+	fheight = (double)(h - h_min) / (double)(h_max - h_min);
+	/* Apply sine transform depending on landscape type */
+	switch (_settings_game.game_creation.landscape) {
+		case LT_TOYLAND:
+		case LT_TEMPERATE:
+			/* Move and scale 0..1 into -1..+1 */
+			fheight = 2 * fheight - 1;
+			/* Sine transform */
+			fheight = sin(fheight * M_PI_2);
+			/* Transform it back from -1..1 into 0..1 space */
+			fheight = 0.5 * (fheight + 1);
+			break;
+
+		case LT_ARCTIC:
+			{
+				/* Arctic terrain needs special height distribution.
+				 * Redistribute heights to have more tiles at highest (75%..100%) range */
+				double sine_upper_limit = 0.75;
+				double linear_compression = 2;
+				if (fheight >= sine_upper_limit) {
+					/* Over the limit we do linear compression up */
+					fheight = 1.0 - (1.0 - fheight) / linear_compression;
+				} else {
+					double m = 1.0 - (1.0 - sine_upper_limit) / linear_compression;
+					/* Get 0..sine_upper_limit into -1..1 */
+					fheight = 2.0 * fheight / sine_upper_limit - 1.0;
+					/* Sine wave transform */
+					fheight = sin(fheight * M_PI_2);
+					/* Get -1..1 back to 0..(1 - (1 - sine_upper_limit) / linear_compression) == 0.0..m */
+					fheight = 0.5 * (fheight + 1.0) * m;
 				}
-				break;
-
-			case LT_TROPIC:
-				{
-					/* Desert terrain needs special height distribution.
-					 * Half of tiles should be at lowest (0..25%) heights */
-					double sine_lower_limit = 0.5;
-					double linear_compression = 2;
-					if (fheight <= sine_lower_limit) {
-						/* Under the limit we do linear compression down */
-						fheight = fheight / linear_compression;
-					} else {
-						double m = sine_lower_limit / linear_compression;
-						/* Get sine_lower_limit..1 into -1..1 */
-						fheight = 2.0 * ((fheight - sine_lower_limit) / (1.0 - sine_lower_limit)) - 1.0;
-						/* Sine wave transform */
-						fheight = sin(fheight * M_PI_2);
-						/* Get -1..1 back to (sine_lower_limit / linear_compression)..1.0 */
-						fheight = 0.5 * ((1.0 - m) * fheight + (1.0 + m));
-					}
+			}
+			break;
+
+		case LT_TROPIC:
+			{
+				/* Desert terrain needs special height distribution.
+				 * Half of tiles should be at lowest (0..25%) heights */
+				double sine_lower_limit = 0.5;
+				double linear_compression = 2;
+				if (fheight <= sine_lower_limit) {
+					/* Under the limit we do linear compression down */
+					fheight = fheight / linear_compression;
+				} else {
+					double m = sine_lower_limit / linear_compression;
+					/* Get sine_lower_limit..1 into -1..1 */
+					fheight = 2.0 * ((fheight - sine_lower_limit) / (1.0 - sine_lower_limit)) - 1.0;
+					/* Sine wave transform */
+					fheight = sin(fheight * M_PI_2);
+					/* Get -1..1 back to (sine_lower_limit / linear_compression)..1.0 */
+					fheight = 0.5 * ((1.0 - m) * fheight + (1.0 + m));
 				}
-				break;
+			}
+			break;
 
-			default:
-				NOT_REACHED();
-				break;
-		}
-		/* Transform it back into h_min..h_max space */
-		h = (Height)(fheight * (h_max - h_min) + h_min);
-		if (h < 0) h = I2H(0);
-		if (h >= h_max) h = h_max - 1;
+		default:
+			NOT_REACHED();
+			break;
 	}
+	/* Transform it back into h_min..h_max space */
+	h = (Height)(fheight * (h_max - h_min) + h_min);
+	if (h < 0) h = I2H(0);
+	if (h >= h_max) h = h_max - 1;
+}
+
+/** Applies sine wave redistribution onto height map */
+static void HeightMapSineTransform(Height h_min, Height h_max)
+{
+	/* Each height is transformed independently, so split the height map over the worker threads. */
+	_general_worker_pool.ParallelFor(0, _height_map.h.size(), 1 << 16, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			HeightMapSineTransformHeight(_height_map.h[i], h_min, h_max);
+		}
+	});
 }
 
 /**
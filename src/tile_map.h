@@ -142,6 +142,7 @@ static inline void SetTileType(TileIndex tile, TileType type)
 	 * the upper edges of the map are also VOID tiles. */
 	dbg_assert_msg(IsInnerTile(tile) == (type != MP_VOID), "tile: 0x%X (%d), type: %d", tile, IsInnerTile(tile), type);
 	SB(_m[tile].type, 4, 4, type);
+	SetNonFloodingWaterTileBit(tile, false);
 }
 
 /**
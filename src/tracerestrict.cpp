@@ -245,8 +245,8 @@ static bool TestStationCondition(StationID station, TraceRestrictItem item)
  */
 void TraceRestrictProgram::Execute(const Train* v, const TraceRestrictProgramInput &input, TraceRestrictProgramResult& out) const
 {
-	// static to avoid needing to re-alloc/resize on each execution
-	static std::vector<TraceRestrictCondStackFlags> condstack;
+	// static to avoid needing to re-alloc/resize on each execution, thread local as pathfinding may run on worker threads
+	static thread_local std::vector<TraceRestrictCondStackFlags> condstack;
 	condstack.clear();
 
 	byte have_previous_signal = 0;
@@ -92,6 +92,9 @@ void GetTrainSpriteSize(EngineID engine, uint &width, uint &height, int &xoffs,
 bool TrainOnCrossing(TileIndex tile);
 void NormalizeTrainVehInDepot(const Train *u);
 
+void PrepareTrainServiceDepotSearches(size_t first, size_t step, bool day_proc);
+void ClearTrainServiceDepotSearches();
+
 inline int GetTrainRealisticBrakingTargetDecelerationLimit(int acceleration_type)
 {
 	return 120 + (acceleration_type * 48);
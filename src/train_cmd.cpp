@@ -46,6 +46,7 @@
 #include "debug_settings.h"
 #include "train_speed_adaptation.h"
 #include "event_logs.h"
+#include "worker_thread.h"
 #include "3rdparty/cpp-btree/btree_map.h"
 
 #include "table/strings.h"
@@ -6752,6 +6753,125 @@ bool Train::Tick()
  * Check whether a train needs service, and if so, find a depot or service it.
  * @return v %Train to check.
  */
+/** Get the maximum penalty of the depot search for servicing a train. */
+static uint GetTrainServiceMaxPenalty()
+{
+	switch (_settings_game.pf.pathfinder_for_trains) {
+		case VPF_NPF:  return _settings_game.pf.npf.maximum_go_to_depot_penalty;
+		case VPF_YAPF: return _settings_game.pf.yapf.maximum_go_to_depot_penalty;
+		default: NOT_REACHED();
+	}
+}
+
+/** Depot search for servicing a train, run ahead of the service check of the train. */
+struct TrainServiceDepotSearch {
+	Train *v;           ///< the train
+	VehicleID index;    ///< index of the train
+	int max_penalty;    ///< maximum penalty the search was run with
+	FindDepotData result;
+};
+
+/** Depot searches run by PrepareTrainServiceDepotSearches, in vehicle index order. */
+static std::vector<TrainServiceDepotSearch> _train_service_depot_searches;
+/** Index of the first depot search in _train_service_depot_searches which has not been used yet. */
+static size_t _train_service_depot_search_next = 0;
+
+/**
+ * Check whether CheckIfTrainNeedsService will search for a depot for a train.
+ * @param v the train
+ * @return true if the service check searches for a depot
+ */
+static bool TrainServiceCheckSearchesDepot(const Train *v)
+{
+	return Company::Get(v->owner)->settings.vehicle.servint_trains != 0 && v->NeedsAutomaticServicing() && !v->IsChainInDepot();
+}
+
+/**
+ * Check whether the 32 day callback of any vehicle of a train runs in this pass of the vehicle day procedure.
+ * The callback may change the train before its service check.
+ * @param v the train
+ * @param first index of the first vehicle of the pass
+ * @param step index increment of the pass
+ * @return true if a 32 day callback of the train runs in this pass
+ */
+static bool TrainHas32DayCallbackInPass(const Train *v, size_t first, size_t step)
+{
+	for (const Train *u = v; u != nullptr; u = u->Next()) {
+		if ((u->index % step) != first || (u->day_counter & 0x1F) != 0) continue;
+		if (u->HasEngineType() && (Engine::Get(u->engine_type)->callbacks_used & SGCU_VEHICLE_32DAY_CALLBACK) != 0) return true;
+	}
+	return false;
+}
+
+/**
+ * Run the depot searches of the trains which will check whether they need servicing in this pass of
+ * Vehicle::OnPeriodic calls, using the worker threads.
+ * This must only be called for a pass which calls Train::OnPeriodic, as the results are otherwise unused.
+ * Nothing which is run between this and the service checks changes the track layout or the reservations, so the
+ * results are identical to searching at the time of the service check.
+ * Trains which may be changed by a 32 day callback first are not included.
+ * ClearTrainServiceDepotSearches must be called once the pass is done.
+ * @param first index of the first vehicle of the pass
+ * @param step index increment of the pass
+ * @param day_proc whether the pass is run by RunVehicleDayProc, which also runs 32 day callbacks
+ */
+void PrepareTrainServiceDepotSearches(size_t first, size_t step, bool day_proc)
+{
+	ClearTrainServiceDepotSearches();
+
+	if (HasChickenBit(DCBF_NO_PARALLEL_DEPOT_SEARCH) || _general_worker_pool.GetWorkerCount() == 0) return;
+	if (_settings_game.pf.pathfinder_for_trains != VPF_YAPF || _debug_yapfdesync_level > 0 || _debug_desync_level >= 2) return;
+
+	const uint max_penalty = GetTrainServiceMaxPenalty();
+	for (size_t i = first; i < Vehicle::GetPoolSize(); i += step) {
+		Vehicle *v = Vehicle::Get(i);
+		if (v == nullptr || v->type != VEH_TRAIN || !Train::From(v)->IsFrontEngine()) continue;
+
+		Train *t = Train::From(v);
+		if (!TrainServiceCheckSearchesDepot(t)) continue;
+		if (day_proc && TrainHas32DayCallbackInPass(t, first, step)) continue;
+
+		_train_service_depot_searches.push_back({ t, t->index, (int)(max_penalty * (t->current_order.IsType(OT_GOTO_DEPOT) ? 2 : 1)), FindDepotData() });
+	}
+
+	if (_train_service_depot_searches.size() < 2) {
+		ClearTrainServiceDepotSearches();
+		return;
+	}
+
+	_general_worker_pool.ParallelFor(0, _train_service_depot_searches.size(), 1, [](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			TrainServiceDepotSearch &search = _train_service_depot_searches[i];
+			search.result = FindClosestTrainDepot(search.v, search.max_penalty);
+		}
+	});
+}
+
+/** Discard the results of the depot searches run by PrepareTrainServiceDepotSearches. */
+void ClearTrainServiceDepotSearches()
+{
+	_train_service_depot_searches.clear();
+	_train_service_depot_search_next = 0;
+}
+
+/**
+ * Find the closest depot for servicing a train, using the result of PrepareTrainServiceDepotSearches if there is one.
+ * @param v the train
+ * @param max_penalty maximum penalty of the search
+ * @return the depot search result
+ */
+static FindDepotData FindClosestTrainServiceDepot(Train *v, int max_penalty)
+{
+	while (_train_service_depot_search_next < _train_service_depot_searches.size()) {
+		const TrainServiceDepotSearch &search = _train_service_depot_searches[_train_service_depot_search_next];
+		if (search.index > v->index) break;
+		_train_service_depot_search_next++;
+		if (search.index == v->index && search.v == v && search.max_penalty == max_penalty) return search.result;
+	}
+
+	return FindClosestTrainDepot(v, max_penalty);
+}
+
 static void CheckIfTrainNeedsService(Train *v)
 {
 	if (Company::Get(v->owner)->settings.vehicle.servint_trains == 0 || !v->NeedsAutomaticServicing()) return;
@@ -6760,14 +6880,9 @@ static void CheckIfTrainNeedsService(Train *v)
 		return;
 	}
 
-	uint max_penalty;
-	switch (_settings_game.pf.pathfinder_for_trains) {
-		case VPF_NPF:  max_penalty = _settings_game.pf.npf.maximum_go_to_depot_penalty;  break;
-		case VPF_YAPF: max_penalty = _settings_game.pf.yapf.maximum_go_to_depot_penalty; break;
-		default: NOT_REACHED();
-	}
+	const uint max_penalty = GetTrainServiceMaxPenalty();
 
-	FindDepotData tfdd = FindClosestTrainDepot(v, max_penalty * (v->current_order.IsType(OT_GOTO_DEPOT) ? 2 : 1));
+	FindDepotData tfdd = FindClosestTrainServiceDepot(v, max_penalty * (v->current_order.IsType(OT_GOTO_DEPOT) ? 2 : 1));
 	/* Only go to the depot if it is not too far out of our way. */
 	if (tfdd.best_length == UINT_MAX || tfdd.best_length > max_penalty * (v->current_order.IsType(OT_GOTO_DEPOT) && v->current_order.GetDestination() == GetDepotIndex(tfdd.tile) ? 2 : 1)) {
 		if (v->current_order.IsType(OT_GOTO_DEPOT)) {
@@ -52,6 +52,7 @@
 #include "depot_map.h"
 #include "gamelog.h"
 #include "tracerestrict.h"
+#include "signal_func.h"
 #include "linkgraph/linkgraph.h"
 #include "linkgraph/refresh.h"
 #include "framerate_type.h"
@@ -66,6 +67,7 @@
 #include "table/strings.h"
 
 #include <algorithm>
+#include <chrono>
 
 #include "safeguards.h"
 
@@ -454,32 +456,92 @@ Vehicle::Vehicle(VehicleType type)
 	this->vcache.cached_veh_flags = 0;
 }
 
-/* Size of the hash, 6 = 64 x 64, 7 = 128 x 128. Larger sizes will (in theory) reduce hash
- * lookup times at the expense of memory usage. */
-const int HASH_BITS = 7;
-const int HASH_SIZE = 1 << HASH_BITS;
-const int HASH_MASK = HASH_SIZE - 1;
-const int TOTAL_HASH_SIZE = 1 << (HASH_BITS * 2);
-const int TOTAL_HASH_MASK = TOTAL_HASH_SIZE - 1;
+/* Maximum number of tile coordinate bits of the tile hash, the hash has at most 1 << VEHICLE_TILE_HASH_MAX_BITS buckets per vehicle type.
+ * The hash is sized from the map dimensions, such that maps up to 512 x 512 have one bucket per tile,
+ * and larger maps only share buckets between tiles which are far apart. */
+static const uint VEHICLE_TILE_HASH_MAX_BITS = 18;
 
-/* Resolution of the hash, 0 = 1*1 tile, 1 = 2*2 tiles, 2 = 4*4 tiles, etc.
- * Profiling results show that 0 is fastest. */
-const int HASH_RES = 0;
+static uint _vehicle_tile_hash_bits_x;          ///< Number of tile X coordinate bits used by the tile hash.
+static uint _vehicle_tile_hash_bits_y;          ///< Number of tile Y coordinate bits used by the tile hash.
+static std::vector<Vehicle *> _vehicle_tile_hash; ///< Tile hash buckets, for each vehicle type in turn.
 
-static Vehicle *_vehicle_tile_hash[TOTAL_HASH_SIZE * 4];
+/**
+ * Get the tile hash bucket of a tile position.
+ * @param x tile X coordinate, this wraps around the hash width
+ * @param y tile Y coordinate, this wraps around the hash height
+ * @param type vehicle type
+ * @return the hash bucket
+ */
+static inline Vehicle **GetVehicleTileHashBucket(uint x, uint y, VehicleType type)
+{
+	const uint bits = _vehicle_tile_hash_bits_x + _vehicle_tile_hash_bits_y;
+	const uint index = GB(x, 0, _vehicle_tile_hash_bits_x) | (GB(y, 0, _vehicle_tile_hash_bits_y) << _vehicle_tile_hash_bits_x);
+	return &_vehicle_tile_hash[index | ((uint)type << bits)];
+}
+
+/**
+ * Get the index of the train tile hash bucket of a tile.
+ * @param tile the tile
+ * @return the bucket index, which is the same for all tiles sharing a bucket
+ */
+uint GetTrainTileHashBucket(TileIndex tile)
+{
+	return GB(TileX(tile), 0, _vehicle_tile_hash_bits_x) | (GB(TileY(tile), 0, _vehicle_tile_hash_bits_y) << _vehicle_tile_hash_bits_x);
+}
+
+/**
+ * Check whether any train is in a train tile hash bucket.
+ * If not, no train can be found on any of the tiles of the bucket.
+ * @param bucket the bucket index, see GetTrainTileHashBucket
+ * @return true if the bucket contains any train
+ */
+bool IsTrainTileHashBucketOccupied(uint bucket)
+{
+	const uint bits = _vehicle_tile_hash_bits_x + _vehicle_tile_hash_bits_y;
+	return _vehicle_tile_hash[bucket | ((uint)VEH_TRAIN << bits)] != nullptr;
+}
+
+/**
+ * Get the index of a train tile hash bucket from its pointer.
+ * @param bucket the bucket
+ * @return the bucket index, see GetTrainTileHashBucket
+ */
+static inline uint GetTrainTileHashBucketIndex(Vehicle * const *bucket)
+{
+	const uint bits = _vehicle_tile_hash_bits_x + _vehicle_tile_hash_bits_y;
+	return (uint)(bucket - &_vehicle_tile_hash[(size_t)VEH_TRAIN << bits]);
+}
+
+/**
+ * Size the tile hash for the current map dimensions.
+ * The hash must be empty.
+ */
+static void SizeVehicleTileHash()
+{
+	uint bits_x = MapLogX();
+	uint bits_y = MapLogY();
+	while (bits_x + bits_y > VEHICLE_TILE_HASH_MAX_BITS) {
+		if (bits_x >= bits_y) {
+			bits_x--;
+		} else {
+			bits_y--;
+		}
+	}
+	_vehicle_tile_hash_bits_x = bits_x;
+	_vehicle_tile_hash_bits_y = bits_y;
+	_vehicle_tile_hash.assign((size_t)VEH_COMPANY_END << (bits_x + bits_y), nullptr);
+}
 
 static Vehicle *VehicleFromTileHash(int xl, int yl, int xu, int yu, VehicleType type, void *data, VehicleFromPosProc *proc, bool find_first)
 {
-	for (int y = yl; ; y = (y + (1 << HASH_BITS)) & (HASH_MASK << HASH_BITS)) {
-		for (int x = xl; ; x = (x + 1) & HASH_MASK) {
-			Vehicle *v = _vehicle_tile_hash[((x + y) & TOTAL_HASH_MASK) + (TOTAL_HASH_SIZE * type)];
+	for (int y = yl; y <= yu; y++) {
+		for (int x = xl; x <= xu; x++) {
+			Vehicle *v = *GetVehicleTileHashBucket(x, y, type);
 			for (; v != nullptr; v = v->hash_tile_next) {
 				Vehicle *a = proc(v, data);
 				if (find_first && a != nullptr) return a;
 			}
-			if (x == xu) break;
 		}
-		if (y == yu) break;
 	}
 
 	return nullptr;
@@ -501,11 +563,11 @@ Vehicle *VehicleFromPosXY(int x, int y, VehicleType type, void *data, VehicleFro
 {
 	const int COLL_DIST = 6;
 
-	/* Hash area to scan is from xl,yl to xu,yu */
-	int xl = GB((x - COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS);
-	int xu = GB((x + COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS);
-	int yl = GB((y - COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS) << HASH_BITS;
-	int yu = GB((y + COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS) << HASH_BITS;
+	/* Tile area to scan is from xl,yl to xu,yu */
+	int xl = (x - COLL_DIST) / TILE_SIZE;
+	int xu = (x + COLL_DIST) / TILE_SIZE;
+	int yl = (y - COLL_DIST) / TILE_SIZE;
+	int yu = (y + COLL_DIST) / TILE_SIZE;
 
 	return VehicleFromTileHash(xl, yl, xu, yu, type, data, proc, find_first);
 }
@@ -522,10 +584,7 @@ Vehicle *VehicleFromPosXY(int x, int y, VehicleType type, void *data, VehicleFro
  */
 Vehicle *VehicleFromPos(TileIndex tile, VehicleType type, void *data, VehicleFromPosProc *proc, bool find_first)
 {
-	int x = GB(TileX(tile), HASH_RES, HASH_BITS);
-	int y = GB(TileY(tile), HASH_RES, HASH_BITS) << HASH_BITS;
-
-	Vehicle *v = _vehicle_tile_hash[((x + y) & TOTAL_HASH_MASK) + (TOTAL_HASH_SIZE * type)];
+	Vehicle *v = *GetVehicleTileHashBucket(TileX(tile), TileY(tile), type);
 	for (; v != nullptr; v = v->hash_tile_next) {
 		if (v->tile != tile) continue;
 
@@ -829,9 +888,7 @@ void UpdateVehicleTileHash(Vehicle *v, bool remove)
 	if (remove || HasBit(v->subtype, GVSF_VIRTUAL) || (v->tile == 0 && _settings_game.construction.freeform_edges)) {
 		new_hash = nullptr;
 	} else {
-		int x = GB(TileX(v->tile), HASH_RES, HASH_BITS);
-		int y = GB(TileY(v->tile), HASH_RES, HASH_BITS) << HASH_BITS;
-		new_hash = &_vehicle_tile_hash[((x + y) & TOTAL_HASH_MASK) + (TOTAL_HASH_SIZE * v->type)];
+		new_hash = GetVehicleTileHashBucket(TileX(v->tile), TileY(v->tile), v->type);
 	}
 
 	if (old_hash == new_hash) return;
@@ -840,6 +897,9 @@ void UpdateVehicleTileHash(Vehicle *v, bool remove)
 	if (old_hash != nullptr) {
 		if (v->hash_tile_next != nullptr) v->hash_tile_next->hash_tile_prev = v->hash_tile_prev;
 		*v->hash_tile_prev = v->hash_tile_next;
+
+		/* The cached signal segments track which train buckets are occupied */
+		if (v->type == VEH_TRAIN && *old_hash == nullptr) NotifySignalSegmentTrainBucketOccupancy(GetTrainTileHashBucketIndex(old_hash), false);
 	}
 
 	/* Insert vehicle at beginning of the new position in the hash table */
@@ -848,6 +908,8 @@ void UpdateVehicleTileHash(Vehicle *v, bool remove)
 		if (v->hash_tile_next != nullptr) v->hash_tile_next->hash_tile_prev = &v->hash_tile_next;
 		v->hash_tile_prev = new_hash;
 		*new_hash = v;
+
+		if (v->type == VEH_TRAIN && v->hash_tile_next == nullptr) NotifySignalSegmentTrainBucketOccupancy(GetTrainTileHashBucketIndex(new_hash), true);
 	}
 
 	/* Remember current hash position */
@@ -863,9 +925,7 @@ bool ValidateVehicleTileHash(const Vehicle *v)
 		return v->hash_tile_current == nullptr;
 	}
 
-	int x = GB(TileX(v->tile), HASH_RES, HASH_BITS);
-	int y = GB(TileY(v->tile), HASH_RES, HASH_BITS) << HASH_BITS;
-	return v->hash_tile_current == &_vehicle_tile_hash[((x + y) & TOTAL_HASH_MASK) + (TOTAL_HASH_SIZE * v->type)];
+	return v->hash_tile_current == GetVehicleTileHashBucket(TileX(v->tile), TileY(v->tile), v->type);
 }
 
 static Vehicle *_vehicle_viewport_hash[1 << (GEN_HASHX_BITS + GEN_HASHY_BITS)];
@@ -943,7 +1003,10 @@ void ResetVehicleHash()
 {
 	for (Vehicle *v : Vehicle::Iterate()) { v->hash_tile_current = nullptr; }
 	memset(_vehicle_viewport_hash, 0, sizeof(_vehicle_viewport_hash));
-	memset(_vehicle_tile_hash, 0, sizeof(_vehicle_tile_hash));
+	SizeVehicleTileHash();
+
+	/* The train occupancy of the cached signal segments refers to the old hash */
+	ClearSignalSegmentCache();
 }
 
 void ResetVehicleColourMap()
@@ -1243,13 +1306,23 @@ void VehicleEnteredDepotThisTick(Vehicle *v)
 	v->vehstatus |= VS_STOPPED;
 }
 
+/**
+ * Check whether Vehicle::OnPeriodic is called together with Vehicle::OnNewDay by RunVehicleDayProc.
+ * Otherwise it is called by CallVehicleTicks at a fixed tick interval.
+ * @return true if Vehicle::OnPeriodic is called by RunVehicleDayProc
+ */
+static inline bool IsVehicleOnPeriodicCalledOnNewDay()
+{
+	/* Vehicle::OnPeriodic is decoupled from Vehicle::OnNewDay at day lengths >= 8 */
+	return _settings_game.economy.day_length_factor < 8;
+}
+
 template <typename T>
 void CallVehicleOnNewDay(Vehicle *v)
 {
 	T::From(v)->T::OnNewDay();
 
-	/* Vehicle::OnPeriodic is decoupled from Vehicle::OnNewDay at day lengths >= 8 */
-	if (_settings_game.economy.day_length_factor < 8) T::From(v)->T::OnPeriodic();
+	if (IsVehicleOnPeriodicCalledOnNewDay()) T::From(v)->T::OnPeriodic();
 }
 
 /**
@@ -1264,6 +1337,7 @@ static void RunVehicleDayProc()
 	/* Run the day_proc for every DAY_TICKS vehicle starting at _date_fract. */
 	Vehicle *v = nullptr;
 	SCOPE_INFO_FMT([&v], "RunVehicleDayProc: %s", scope_dumper().VehicleInfo(v));
+	if (IsVehicleOnPeriodicCalledOnNewDay()) PrepareTrainServiceDepotSearches(_date_fract, DAY_TICKS, true);
 	for (size_t i = _date_fract; i < Vehicle::GetPoolSize(); i += DAY_TICKS) {
 		v = Vehicle::Get(i);
 		if (v == nullptr) continue;
@@ -1302,6 +1376,7 @@ static void RunVehicleDayProc()
 				break;
 		}
 	}
+	ClearTrainServiceDepotSearches();
 }
 
 static void ShowAutoReplaceAdviceMessage(const CommandCost &res, const Vehicle *v)
@@ -1465,7 +1540,7 @@ void CallVehicleTicks()
 
 	if (_tick_skip_counter == 0) RunVehicleDayProc();
 
-	if (_settings_game.economy.day_length_factor >= 8 && _game_mode == GM_NORMAL) {
+	if (!IsVehicleOnPeriodicCalledOnNewDay() && _game_mode == GM_NORMAL) {
 		/*
 		 * Vehicle::OnPeriodic is decoupled from Vehicle::OnNewDay at day lengths >= 8
 		 * Use a fixed interval of 512 ticks (unscaled) instead
@@ -1473,6 +1548,7 @@ void CallVehicleTicks()
 
 		Vehicle *v = nullptr;
 		SCOPE_INFO_FMT([&v], "CallVehicleTicks -> OnPeriodic: %s", scope_dumper().VehicleInfo(v));
+		PrepareTrainServiceDepotSearches((size_t)(_scaled_tick_counter & 0x1FF), 0x200, false);
 		for (size_t i = (size_t)(_scaled_tick_counter & 0x1FF); i < Vehicle::GetPoolSize(); i += 0x200) {
 			v = Vehicle::Get(i);
 			if (v == nullptr) continue;
@@ -1495,6 +1571,7 @@ void CallVehicleTicks()
 					break;
 			}
 		}
+		ClearTrainServiceDepotSearches();
 	}
 
 	{
@@ -4575,6 +4652,89 @@ void DumpVehicleStats(char *buffer, const char *last)
 	buffer += seprintf(buffer, last, "  %10s: %5u\n", "total", (uint)Vehicle::GetNumItems());
 }
 
+static Vehicle *CountVehicleTileHashProbeProc(Vehicle *v, void *data)
+{
+	(*static_cast<uint *>(data))++;
+	return nullptr;
+}
+
+/**
+ * Dump the occupancy of the vehicle tile hash.
+ * The occupancy of the fixed 128 x 128 tile hash used previously is also shown, for comparison.
+ * @param buffer output buffer
+ * @param last last valid char of the output buffer
+ * @param probe_rounds if non-zero, also time this many rounds of VehicleFromPos probes at the tile of every hashed vehicle
+ */
+void DumpVehicleTileHashStats(char *buffer, const char *last, uint probe_rounds)
+{
+	const uint LEGACY_HASH_BITS = 7;
+	const uint bits = _vehicle_tile_hash_bits_x + _vehicle_tile_hash_bits_y;
+	const size_t type_buckets = (size_t)1 << bits;
+
+	buffer += seprintf(buffer, last, "Tile hash: %u x %u buckets per vehicle type (map: %u x %u)\n",
+			1U << _vehicle_tile_hash_bits_x, 1U << _vehicle_tile_hash_bits_y, MapSizeX(), MapSizeY());
+
+	static const char * const type_names[VEH_COMPANY_END] = { "train", "road", "ship", "aircraft" };
+	for (uint type = 0; type < VEH_COMPANY_END; type++) {
+		uint vehicles = 0;
+		uint used = 0;
+		uint max_chain = 0;
+		uint64 current_walk = 0;
+		for (size_t i = 0; i < type_buckets; i++) {
+			uint chain = 0;
+			for (const Vehicle *v = _vehicle_tile_hash[(type << bits) | i]; v != nullptr; v = v->hash_tile_next) chain++;
+			if (chain == 0) continue;
+			used++;
+			vehicles += chain;
+			max_chain = std::max(max_chain, chain);
+			current_walk += (uint64)chain * chain;
+		}
+		if (vehicles == 0) continue;
+
+		std::vector<uint> legacy(1 << (LEGACY_HASH_BITS * 2), 0);
+		for (const Vehicle *v : Vehicle::Iterate()) {
+			if (v->type == type && v->hash_tile_current != nullptr) {
+				legacy[GB(TileX(v->tile), 0, LEGACY_HASH_BITS) | (GB(TileY(v->tile), 0, LEGACY_HASH_BITS) << LEGACY_HASH_BITS)]++;
+			}
+		}
+		uint legacy_used = 0;
+		uint legacy_max_chain = 0;
+		uint64 legacy_walk = 0;
+		for (uint chain : legacy) {
+			if (chain == 0) continue;
+			legacy_used++;
+			legacy_max_chain = std::max(legacy_max_chain, chain);
+			legacy_walk += (uint64)chain * chain;
+		}
+
+		/* The mean walk length is the mean chain length seen by a VehicleFromPos probe at the tile of a hashed vehicle. */
+		buffer += seprintf(buffer, last, "  %8s: %6u vehicles\n", type_names[type], vehicles);
+		buffer += seprintf(buffer, last, "    current:   %7u buckets used, max chain: %5u, mean walk: %.2f\n", used, max_chain, (double)current_walk / vehicles);
+		buffer += seprintf(buffer, last, "    128 x 128: %7u buckets used, max chain: %5u, mean walk: %.2f\n", legacy_used, legacy_max_chain, (double)legacy_walk / vehicles);
+	}
+
+	if (probe_rounds == 0) return;
+
+	std::vector<std::pair<TileIndex, VehicleType>> probes;
+	for (const Vehicle *v : Vehicle::Iterate()) {
+		if (v->hash_tile_current != nullptr) probes.push_back({ v->tile, v->type });
+	}
+	if (probes.empty()) return;
+
+	uint found = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (uint round = 0; round < probe_rounds; round++) {
+		for (const auto &probe : probes) {
+			VehicleFromPos(probe.first, probe.second, &found, &CountVehicleTileHashProbeProc, false);
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	const uint64 total_probes = (uint64)probes.size() * probe_rounds;
+	const uint64 ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	buffer += seprintf(buffer, last, "Probe: " OTTD_PRINTF64U " VehicleFromPos probes in " OTTD_PRINTF64U " us, %.1f ns/probe, %.2f vehicles/probe\n",
+			total_probes, ns / 1000, (double)ns / total_probes, (double)found / total_probes);
+}
+
 void AdjustVehicleScaledTickBase(int64 delta)
 {
 	for (Vehicle *v : Vehicle::Iterate()) {
@@ -88,6 +88,34 @@ struct NewGRFCache {
 	uint8  cache_valid;               ///< Bitset that indicates which cache values are valid.
 };
 
+/**
+ * Memoised results of NewGRF vehicle callbacks, see GetVehicleCallback and GetEngineProperty.
+ * The results are valid for the tick, cargo type and cargo subtype they were stored in, and are cleared with the NewGRF cache.
+ */
+struct VehicleCallbackMemo {
+	static const uint MAX_ENTRIES = 4;
+
+	struct Entry {
+		uint32 param1;
+		uint32 param2;
+		uint16 callback;
+		uint16 result;
+	};
+
+	uint64 tick = 0;             ///< Scaled tick counter when the entries were stored.
+	Entry entries[MAX_ENTRIES];
+	uint8 count = 0;             ///< Number of valid entries.
+	uint8 next = 0;              ///< Entry to replace next, when all entries are in use.
+	CargoID cargo_type;          ///< Cargo type when the entries were stored.
+	byte cargo_subtype;          ///< Cargo subtype when the entries were stored.
+
+	inline void Clear()
+	{
+		this->count = 0;
+		this->next = 0;
+	}
+};
+
 /** Meaning of the various bits of the visual effect. */
 enum VisualEffect {
 	VE_OFFSET_START        = 0, ///< First bit that contains the offset (0 = front, 8 = centre, 15 = rear)
@@ -393,6 +421,7 @@ public:
 	Direction cur_image_valid_dir;      ///< NOSAVE: direction for which cur_image does not need to be regenerated on the next tick
 
 	NewGRFCache grf_cache;              ///< Cache of often used calculated NewGRF values
+	mutable VehicleCallbackMemo callback_memo; ///< NOSAVE: Memoised NewGRF callback results, see #VehicleCallbackMemo
 	VehicleCache vcache;                ///< Cache of often used vehicle values.
 
 	/**
@@ -530,6 +559,7 @@ public:
 	inline void InvalidateNewGRFCache()
 	{
 		this->grf_cache.cache_valid = 0;
+		this->callback_memo.Clear();
 	}
 
 	/**
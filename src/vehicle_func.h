@@ -123,6 +123,8 @@ uint8 CalcPercentVehicleFilledOfCargo(const Vehicle *v, CargoID cargo);
 void VehicleLengthChanged(const Vehicle *u);
 
 void ResetVehicleHash();
+uint GetTrainTileHashBucket(TileIndex tile);
+bool IsTrainTileHashBucketOccupied(uint bucket);
 void ResetVehicleColourMap();
 
 byte GetBestFittingSubType(Vehicle *v_from, Vehicle *v_for, CargoID dest_cargo_type);
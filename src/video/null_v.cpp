@@ -13,6 +13,8 @@
 #include "../sl/saveload.h"
 #include "../window_func.h"
 #include "../thread.h"
+#include "../framerate_type.h"
+#include "../openttd.h"
 #include "null_v.h"
 
 #include <atomic>
@@ -35,6 +37,9 @@ const char *VideoDriver_Null::Start(const StringList &parm)
 
 	this->ticks = GetDriverParamInt(parm, "ticks", 1000);
 	this->until_exit = GetDriverParamBool(parm, "until_exit");
+	const char *benchmark = GetDriverParam(parm, "benchmark");
+	this->benchmark = (benchmark != nullptr);
+	this->benchmark_file = (benchmark != nullptr) ? benchmark : "";
 	_screen.width  = _screen.pitch = _cur_resolution.width;
 	_screen.height = _cur_resolution.height;
 	_screen.dst_ptr = nullptr;
@@ -59,6 +64,21 @@ void VideoDriver_Null::MainLoop()
 			::InputLoop();
 			::UpdateWindows();
 		}
+	} else if (this->benchmark) {
+		/* Let any pending game load or world generation finish before measuring. */
+		do {
+			::GameLoop();
+			::InputLoop();
+			::UpdateWindows();
+		} while (_switch_mode != SM_NONE);
+
+		StartPerformanceBenchmark();
+		for (int i = 0; i < this->ticks; i++) {
+			::GameLoop();
+			::InputLoop();
+			::UpdateWindows();
+		}
+		WritePerformanceBenchmarkReport(this->benchmark_file, this->ticks);
 	} else {
 		for (int i = 0; i < this->ticks; i++) {
 			::GameLoop();
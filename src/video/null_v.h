@@ -17,6 +17,8 @@ class VideoDriver_Null : public VideoDriver {
 private:
 	int ticks; ///< Amount of ticks to run.
 	bool until_exit;
+	bool benchmark;             ///< Whether to write a benchmark report of the ticks run.
+	std::string benchmark_file; ///< File to write the benchmark report to, empty for stdout.
 
 public:
 	const char *Start(const StringList &param) override;
@@ -3775,9 +3775,9 @@ void ViewportDoDraw(Viewport *vp, int left, int top, int right, int bottom, uint
 		if (unlikely(HasBit(_viewport_debug_flags, VDF_DISABLE_THREAD))) {
 			ViewportDoDrawRenderJob(vp, _vdd.release());
 		} else {
-			_general_worker_pool.EnqueueJob([](void *data1, void *data2, void *data3) {
-				ViewportDoDrawRenderJob(static_cast<Viewport *>(data1), static_cast<ViewportDrawerDynamic *>(data2));
-			}, vp, _vdd.release());
+			_general_worker_pool.EnqueueTask([vp, vdd = _vdd.release()]() {
+				ViewportDoDrawRenderJob(vp, vdd);
+			});
 		}
 	}
 }
@@ -3831,9 +3831,9 @@ static void ViewportDoDrawRenderJob(Viewport *vp, ViewportDrawerDynamic *vdd)
 		if (unlikely(HasBit(_viewport_debug_flags, VDF_DISABLE_THREAD))) {
 			ViewportDoDrawRenderSubJob(vp, vdd, i);
 		} else {
-			_general_worker_pool.EnqueueJob([](void *data1, void *data2, void *data3) {
-				ViewportDoDrawRenderSubJob(static_cast<Viewport *>(data1), static_cast<ViewportDrawerDynamic *>(data2), static_cast<uint>(reinterpret_cast<uintptr_t>(data3)));
-			}, vp, vdd, reinterpret_cast<void *>(static_cast<uintptr_t>(i)));
+			_general_worker_pool.EnqueueTask([vp, vdd, i]() {
+				ViewportDoDrawRenderSubJob(vp, vdd, i);
+			});
 		}
 	}
 
@@ -514,6 +514,7 @@ static inline void SetNonFloodingWaterTile(TileIndex t, bool b)
 {
 	dbg_assert(IsTileType(t, MP_WATER));
 	SB(_m[t].m3, 0, 1, b ? 1 : 0);
+	SetNonFloodingWaterTileBit(t, b);
 }
 /**
  * Checks whether the tile is marked as a non-flooding water tile.
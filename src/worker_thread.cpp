@@ -15,6 +15,51 @@
 
 WorkerThreadPool _general_worker_pool;
 
+/** The pool which the current thread is a worker of, if any. */
+static thread_local WorkerThreadPool *_current_worker_pool = nullptr;
+/** The queue index of the current worker thread, if any. */
+static thread_local uint _current_worker_index = 0;
+
+/** Number of WorkerThreadPoolInlineScope instances of the current thread. */
+thread_local uint WorkerThreadPoolInlineScope::depth = 0;
+
+/**
+ * Check whether the current thread is in a WorkerThreadPoolInlineScope.
+ * @return true if tasks must be run immediately on the current thread
+ */
+/* static */ bool WorkerThreadPool::IsRunInlineOnly()
+{
+	return WorkerThreadPoolInlineScope::depth != 0;
+}
+
+void WorkerWaitGroup::Add(uint count)
+{
+	std::lock_guard<std::mutex> lk(this->lock);
+	this->pending += count;
+}
+
+void WorkerWaitGroup::Done()
+{
+	WorkerThreadPool *pool;
+	{
+		std::lock_guard<std::mutex> lk(this->lock);
+		this->pending--;
+		this->done_cv.notify_all();
+		pool = (this->helpers != 0) ? this->helping_pool : nullptr;
+	}
+	if (pool != nullptr) {
+		/* Helping worker threads wait on the pool condition variable, take the pool lock to avoid a lost wakeup. */
+		std::lock_guard<std::mutex> lk(pool->lock);
+		pool->worker_wait_cv.notify_all();
+	}
+}
+
+bool WorkerWaitGroup::IsDone()
+{
+	std::lock_guard<std::mutex> lk(this->lock);
+	return this->pending == 0;
+}
+
 void WorkerThreadPool::Start(const char *thread_name, uint max_workers)
 {
 	uint cpus = std::thread::hardware_concurrency();
@@ -27,11 +72,16 @@ void WorkerThreadPool::Start(const char *thread_name, uint max_workers)
 	uint worker_target = std::min<uint>(max_workers, cpus);
 	if (this->workers >= worker_target) return;
 
+	/* Queues are never removed, so that stealing workers never see a queue disappear. */
+	while (this->queues.size() < worker_target) {
+		this->queues.push_back(std::make_unique<WorkerQueue>());
+	}
+
 	uint new_workers = worker_target - this->workers;
 
 	for (uint i = 0; i < new_workers; i++) {
-		this->workers++;
-		if (!StartNewThread(nullptr, thread_name, &WorkerThreadPool::Run, this)) {
+		uint index = this->workers++;
+		if (!StartNewThread(nullptr, thread_name, &WorkerThreadPool::Run, this, static_cast<uint>(index))) {
 			this->workers--;
 			return;
 		}
@@ -46,37 +96,161 @@ void WorkerThreadPool::Stop()
 	this->done_cv.wait(lk, [this]() { return this->workers == 0; });
 }
 
-void WorkerThreadPool::EnqueueJob(WorkerJobFunc *func, void *data1, void *data2, void *data3)
+/**
+ * Wake one waiting worker, if there is one.
+ * This must be called after incrementing the queued count.
+ */
+void WorkerThreadPool::NotifyWorker()
 {
-	std::unique_lock<std::mutex> lk(this->lock);
-	if (this->workers == 0) {
+	if (this->workers_waiting.load() == 0) return;
+
+	/* Take the lock to avoid a lost wakeup between a worker checking the queued count and waiting. */
+	{
+		std::lock_guard<std::mutex> lk(this->lock);
+	}
+	this->worker_wait_cv.notify_one();
+}
+
+void WorkerThreadPool::EnqueueTask(WorkerTask task)
+{
+	const uint workers = this->workers.load();
+	if (workers == 0 || IsRunInlineOnly()) {
 		/* Just execute it here and now */
-		lk.unlock();
+		task();
+		return;
+	}
+
+	uint index;
+	if (_current_worker_pool == this) {
+		index = _current_worker_index;
+	} else {
+		index = this->next_queue++ % workers;
+	}
+
+	WorkerQueue &queue = *this->queues[index];
+	{
+		std::lock_guard<std::mutex> lk(queue.lock);
+		queue.tasks.push_back(std::move(task));
+	}
+	this->queued++;
+	this->NotifyWorker();
+}
+
+void WorkerThreadPool::EnqueueJob(WorkerJobFunc *func, void *data1, void *data2, void *data3)
+{
+	this->EnqueueTask([func, data1, data2, data3]() {
 		func(data1, data2, data3);
+	});
+}
+
+/**
+ * Take a task from the queue of the given worker, or steal one from another worker's queue.
+ * @param index queue index of the worker
+ * @param task output: the task
+ * @return whether a task was found
+ */
+bool WorkerThreadPool::PopTask(uint index, WorkerTask &task)
+{
+	if (this->queued.load() == 0) return false;
+
+	{
+		WorkerQueue &queue = *this->queues[index];
+		std::lock_guard<std::mutex> lk(queue.lock);
+		if (!queue.tasks.empty()) {
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+			this->queued--;
+			return true;
+		}
+	}
+
+	const uint count = (uint)this->queues.size();
+	for (uint i = 1; i < count; i++) {
+		WorkerQueue &queue = *this->queues[(index + i) % count];
+		std::lock_guard<std::mutex> lk(queue.lock);
+		if (!queue.tasks.empty()) {
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+			this->queued--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Wait until at most max_pending tasks of the given wait group are outstanding.
+ * When called from a worker thread of this pool, that thread runs queued tasks while waiting.
+ * @param group wait group to wait on
+ * @param max_pending maximum number of outstanding tasks to return with
+ */
+void WorkerThreadPool::Wait(WorkerWaitGroup &group, uint max_pending)
+{
+	if (_current_worker_pool == this && !IsRunInlineOnly()) {
+		auto is_done = [&]() -> bool {
+			std::lock_guard<std::mutex> lk(group.lock);
+			return group.pending <= max_pending;
+		};
+
+		WorkerTask task;
+		while (!is_done()) {
+			if (this->PopTask(_current_worker_index, task)) {
+				task();
+				task = nullptr;
+				continue;
+			}
+
+			/*
+			 * Wait like an idle worker, so that NotifyWorker wakes this thread when a task is enqueued.
+			 * Register with the group first, so that WorkerWaitGroup::Done also wakes this thread.
+			 */
+			{
+				std::lock_guard<std::mutex> lk(group.lock);
+				group.helpers++;
+				group.helping_pool = this;
+			}
+			{
+				std::unique_lock<std::mutex> lk(this->lock);
+				this->workers_waiting++;
+				this->worker_wait_cv.wait(lk, [&]() { return this->queued.load() != 0 || is_done(); });
+				this->workers_waiting--;
+			}
+			{
+				std::lock_guard<std::mutex> lk(group.lock);
+				group.helpers--;
+			}
+		}
 		return;
 	}
-	bool notify = this->jobs.size() < (size_t)this->workers_waiting;
-	this->jobs.push({ func, data1, data2, data3 });
-	lk.unlock();
-	if (notify) this->worker_wait_cv.notify_one();
+
+	std::unique_lock<std::mutex> lk(group.lock);
+	group.done_cv.wait(lk, [&]() { return group.pending <= max_pending; });
 }
 
-void WorkerThreadPool::Run(WorkerThreadPool *pool)
+void WorkerThreadPool::Run(WorkerThreadPool *pool, uint index)
 {
-	std::unique_lock<std::mutex> lk(pool->lock);
-	while (!pool->exit || !pool->jobs.empty()) {
-		if (pool->jobs.empty()) {
-			pool->workers_waiting++;
-			pool->worker_wait_cv.wait(lk);
-			pool->workers_waiting--;
-		} else {
-			WorkerJob job = pool->jobs.front();
-			pool->jobs.pop();
-			lk.unlock();
-			job.func(job.data1, job.data2, job.data3);
-			lk.lock();
+	_current_worker_pool = pool;
+	_current_worker_index = index;
+
+	WorkerTask task;
+	while (true) {
+		if (pool->PopTask(index, task)) {
+			task();
+			task = nullptr;
+			continue;
 		}
+
+		std::unique_lock<std::mutex> lk(pool->lock);
+		if (pool->queued.load() != 0) continue;
+		if (pool->exit) break;
+		pool->workers_waiting++;
+		pool->worker_wait_cv.wait(lk, [pool]() { return pool->queued.load() != 0 || pool->exit; });
+		pool->workers_waiting--;
 	}
+
+	_current_worker_pool = nullptr;
+	std::lock_guard<std::mutex> lk(pool->lock);
 	pool->workers--;
 	if (pool->workers == 0) {
 		pool->done_cv.notify_all();
@@ -10,7 +10,11 @@
 #ifndef WORKER_THREAD_H
 #define WORKER_THREAD_H
 
-#include <queue>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
 #include <mutex>
 #include <condition_variable>
 #if defined(__MINGW32__)
@@ -20,30 +24,148 @@
 
 typedef void WorkerJobFunc(void *, void *, void *);
 
+/** A task which can be run on a WorkerThreadPool. */
+using WorkerTask = std::function<void()>;
+
+struct WorkerThreadPool;
+
+/**
+ * Counter of outstanding tasks, which can be waited on.
+ * Call Add() before enqueueing a task, and Done() at the end of the task.
+ */
+struct WorkerWaitGroup {
+private:
+	uint pending = 0;
+	uint helpers = 0;                          ///< Number of worker threads of helping_pool which are waiting on this group.
+	WorkerThreadPool *helping_pool = nullptr;  ///< Pool of the helping worker threads, these wait on the pool's worker_wait_cv.
+	std::mutex lock;
+	std::condition_variable done_cv;
+
+	friend struct WorkerThreadPool;
+
+public:
+	void Add(uint count = 1);
+	void Done();
+	bool IsDone();
+};
+
+/**
+ * Work-stealing worker thread pool.
+ *
+ * Each worker thread has its own task deque. Tasks enqueued from a worker thread are pushed onto
+ * the back of that worker's deque and are popped from the back by the same worker (LIFO), idle
+ * workers steal from the front of the other deques (FIFO). Tasks enqueued from any other thread
+ * are distributed over the worker deques in round-robin order.
+ *
+ * If the pool has no workers (e.g. single CPU systems), tasks are run immediately by the thread
+ * which enqueues them.
+ */
 struct WorkerThreadPool {
 private:
-	struct WorkerJob {
-		WorkerJobFunc *func;
-		void *data1;
-		void *data2;
-		void *data3;
+	struct WorkerQueue {
+		std::mutex lock;
+		std::deque<WorkerTask> tasks;
 	};
 
-	uint workers = 0;
-	uint workers_waiting = 0;
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+	std::atomic<uint> workers = 0;
+	std::atomic<uint> workers_waiting = 0;
+	std::atomic<size_t> queued = 0;
+	std::atomic<uint> next_queue = 0;
 	bool exit = false;
 	std::mutex lock;
-	std::queue<WorkerJob> jobs;
 	std::condition_variable worker_wait_cv;
 	std::condition_variable done_cv;
 
-	static void Run(WorkerThreadPool *pool);
+	friend struct WorkerWaitGroup;
+
+	static void Run(WorkerThreadPool *pool, uint index);
+	static bool IsRunInlineOnly();
+
+	bool PopTask(uint index, WorkerTask &task);
+	void NotifyWorker();
 
 public:
 
 	void Start(const char *thread_name, uint max_workers);
 	void Stop();
+	void EnqueueTask(WorkerTask task);
 	void EnqueueJob(WorkerJobFunc *func, void *data1 = nullptr, void *data2 = nullptr, void *data3 = nullptr);
+	void Wait(WorkerWaitGroup &group, uint max_pending = 0);
+
+	/**
+	 * Enqueue a task, which is tracked by the given wait group.
+	 * @param group wait group to add the task to
+	 * @param task task to run
+	 */
+	void EnqueueTask(WorkerWaitGroup &group, WorkerTask task)
+	{
+		group.Add();
+		this->EnqueueTask([&group, task = std::move(task)]() {
+			task();
+			group.Done();
+		});
+	}
+
+	/**
+	 * Get the number of worker threads in this pool.
+	 * @return number of worker threads, this is 0 if tasks are run immediately
+	 */
+	uint GetWorkerCount() const
+	{
+		return this->workers.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * Run func over the range [begin, end) split into chunks of at most grain items, using the worker threads and the calling thread.
+	 * This returns when all chunks have been processed.
+	 * The chunk boundaries only depend on the range and grain size, not on the number of worker threads.
+	 * The helper tasks refer to func, this is safe as func is only called while this function waits for the chunks.
+	 * @param begin start of the range
+	 * @param end end of the range (exclusive)
+	 * @param grain maximum number of items per chunk
+	 * @param func function called as func(chunk_begin, chunk_end) for each chunk
+	 */
+	template <typename F>
+	void ParallelFor(size_t begin, size_t end, size_t grain, F func)
+	{
+		if (end <= begin) return;
+		if (grain == 0) grain = 1;
+		const size_t chunks = (end - begin + grain - 1) / grain;
+		const uint workers = this->GetWorkerCount();
+		if (chunks == 1 || workers == 0 || IsRunInlineOnly()) {
+			for (size_t i = begin; i < end; i += grain) {
+				func(i, std::min(i + grain, end));
+			}
+			return;
+		}
+
+		struct ParallelForState {
+			std::atomic<size_t> next_chunk = 0;
+			std::atomic<bool> func_valid = true;
+			WorkerWaitGroup group;
+		};
+		/* Helper tasks may start after this function has returned, they then find no chunks left to run, and do not call func. */
+		std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>();
+		state->group.Add((uint)chunks);
+
+		auto run_chunks = [state, begin, end, grain, chunks, &func]() {
+			for (size_t chunk = state->next_chunk++; chunk < chunks; chunk = state->next_chunk++) {
+				const size_t chunk_begin = begin + (chunk * grain);
+				dbg_assert(state->func_valid.load(std::memory_order_relaxed));
+				func(chunk_begin, std::min(chunk_begin + grain, end));
+				state->group.Done();
+			}
+		};
+
+		const uint helpers = (uint)std::min<size_t>(workers, chunks - 1);
+		for (uint i = 0; i < helpers; i++) {
+			this->EnqueueTask(run_chunks);
+		}
+		run_chunks();
+		this->Wait(state->group);
+		state->func_valid.store(false, std::memory_order_relaxed);
+	}
 
 	~WorkerThreadPool()
 	{
@@ -51,6 +173,29 @@ public:
 	}
 };
 
+/**
+ * Scope in which the current thread must not run tasks other than its own.
+ * Tasks which it enqueues on a WorkerThreadPool are run immediately by it, ParallelFor runs all chunks on it,
+ * and waiting blocks instead of running queued tasks.
+ * This is for threads which hold a lock that queued tasks may also need, see ScriptParallelScope.
+ */
+class WorkerThreadPoolInlineScope {
+	static thread_local uint depth;
+
+	friend struct WorkerThreadPool;
+
+public:
+	WorkerThreadPoolInlineScope()
+	{
+		depth++;
+	}
+
+	~WorkerThreadPoolInlineScope()
+	{
+		depth--;
+	}
+};
+
 extern WorkerThreadPool _general_worker_pool;
 
 #endif /* WORKER_THREAD_H */